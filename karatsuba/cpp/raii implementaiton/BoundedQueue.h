@@ -0,0 +1,98 @@
+//
+// BoundedQueue.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class template for a bounded, closable, multi-producer/multi-consumer queue
+// (using RAII patterns); the hand-off between the stages of a pipeline.
+//
+#ifndef __bounded_queue_h
+#define __bounded_queue_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+template<typename T>
+class BoundedQueue
+//
+// A FIFO of at most 'capacity' items. Producers block while it's full, and
+// consumers while it's empty, so a fast stage can't run away from a slow one.
+// Closing it wakes everybody up: pushes fail from then on, and pops drain
+// what's left and then come back empty.
+//
+{
+    std::mutex lock;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed = false;
+
+public:
+    // constructors
+    explicit BoundedQueue( std::size_t capacity ) : capacity( capacity )
+    {
+        if ( capacity == 0 )
+            throw std::invalid_argument( "a bounded queue needs room for at least one item" );
+    }
+
+    // copy & move semantics (threads are blocked on it, so neither)
+    BoundedQueue( const BoundedQueue& ) = delete;
+    BoundedQueue& operator=( const BoundedQueue& ) = delete;
+
+    // wait for room and add item; false (and item dropped) if the queue is closed
+    bool push( T item )
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        not_full.wait( guard, [this]{ return closed || items.size() < capacity; } );
+        if ( closed )
+            return false;
+
+        items.push_back( std::move(item) );
+        not_empty.notify_one();
+        return true;
+    }
+
+    // wait for an item and take it; nothing once the queue is closed and empty
+    std::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        not_empty.wait( guard, [this]{ return closed || !items.empty(); } );
+        if ( items.empty() )
+            return std::nullopt;
+
+        std::optional<T> item( std::move( items.front() ) );
+        items.pop_front();
+        not_full.notify_one();
+        return item;
+    }
+
+    // take an item if there's one waiting, without blocking
+    std::optional<T> try_pop()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        if ( items.empty() )
+            return std::nullopt;
+
+        std::optional<T> item( std::move( items.front() ) );
+        items.pop_front();
+        not_full.notify_one();
+        return item;
+    }
+
+    // no more pushes (items already queued can still be popped)
+    void close()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+};
+
+#endif // __bounded_queue_h
@@ -0,0 +1,30 @@
+//
+// CommandLine.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// command-line helpers shared by the bigmul tools (bigmul, bigmul_load)
+//
+#ifndef __command_line_h
+#define __command_line_h
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// thrown for anything wrong with the command line (exit status 2)
+struct usage_error : std::runtime_error { using std::runtime_error::runtime_error; };
+
+// the value of option 'name' as a count (> 0); throws usage_error otherwise
+inline unsigned long parse_count( std::string_view name, std::string_view value )
+{
+    unsigned long n = 0;
+    auto [ptr, ec] = std::from_chars( value.data(), value.data() + value.size(), n );
+    if ( ec != std::errc() || ptr != value.data() + value.size() || n == 0 )
+        throw usage_error( std::string(name) + " needs a positive number, not '" + std::string(value) + "'" );
+    return n;
+}
+
+#endif // __command_line_h
@@ -0,0 +1,204 @@
+//
+// FixedIntList.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// unit tests for the fixed-capacity integer list type (the class template
+// itself is defined entirely in FixedIntList.h)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -DBUILD_FIXEDINTLIST_UNIT_TEST_RUNNER IntList.cpp FixedIntList.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_FIXEDINTLIST_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE FixedIntList Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_FIXEDINTLIST_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <cstdlib>
+#include <ctime>
+
+#include "FixedIntList.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+#ifdef BUILD_UNIT_TESTS
+
+
+
+BOOST_AUTO_TEST_CASE(fixedintlist_initialization_tests)
+{
+    {   //
+        // zero
+        //
+        FixedIntList<8> z;
+        BOOST_CHECK( z.size() == 1 );
+        BOOST_CHECK( z.to_str() == "0" );
+        BOOST_CHECK( z.to_int_list() == IntList(0) );
+    }
+
+    {   //
+        // to and from unsigned int and IntList
+        //
+        FixedIntList<10> a( 4294967295u );
+        BOOST_CHECK( a.to_str() == "4294967295" );
+        BOOST_CHECK( a.to_int_list() == IntList(4294967295u) );
+        BOOST_CHECK( FixedIntList<10>( IntList(61587) ).to_str() == "61587" );
+        BOOST_CHECK( FixedIntList<10>( IntList(61587) ).size() == 5 );
+    }
+
+    {   //
+        // values that don't fit are rejected
+        //
+        BOOST_CHECK_THROW( FixedIntList<3> f( 1000 ), std::out_of_range );
+        BOOST_CHECK_THROW( FixedIntList<3> f( IntList(1000) ), std::out_of_range );
+        BOOST_CHECK_NO_THROW( FixedIntList<3> f( 999 ) );
+    }
+
+    {   //
+        // widening keeps the value
+        //
+        FixedIntList<4> small( 1234 );
+        FixedIntList<64> wide = small;
+        BOOST_CHECK( wide.to_str() == "1234" );
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(fixedintlist_comparison_operator_tests)
+{
+    FixedIntList<16> a( 9999 );
+    FixedIntList<16> b( 49999 );
+
+    BOOST_CHECK( a < b );
+    BOOST_CHECK( b > a );
+    BOOST_CHECK( a == FixedIntList<16>( IntList {0,0,9,9,9,9} ) );
+    BOOST_CHECK( a != b );
+}
+
+
+
+BOOST_AUTO_TEST_CASE(fixedintlist_arithmetic_operator_tests)
+{
+    {   //
+        // carries and borrows across the whole width
+        //
+        FixedIntList<4> a( 9999 );
+        FixedIntList<1> b( 1 );
+        BOOST_CHECK( (a + b).to_str() == "10000" );
+        BOOST_CHECK( (a - b).to_str() == "9998" );
+        BOOST_CHECK( (FixedIntList<5>( 10000 ) - b).to_str() == "9999" );
+        BOOST_CHECK( (a * a).to_str() == "99980001" );
+    }
+
+    {   //
+        // make sure that negative differences are rejected
+        //
+        FixedIntList<4> a( 998 );
+        FixedIntList<4> b( 999 );
+        BOOST_CHECK_THROW( a - b, std::invalid_argument );
+    }
+
+    {   //
+        // double-checking random values against IntList arithmetic
+        //
+        std::srand(time(nullptr));
+
+        for ( int i=0; i < 200; i++ ) {
+            auto x = random_int_list( 1 + std::rand() % 64 );
+            auto y = random_int_list( 1 + std::rand() % 64 );
+            if ( x < y )
+                std::swap( x, y );
+
+            FixedIntList<64> fx( x );
+            FixedIntList<64> fy( y );
+
+            BOOST_CHECK( (fx + fy).to_int_list() == x + y );
+            BOOST_CHECK( (fx - fy).to_int_list() == x - y );
+
+            // long multiplication out of shifted IntList sums for reference
+            IntList xy(0);
+            unsigned long pos = 0;
+            for ( auto d = y.crbegin(); d != y.crend(); ++d )
+                xy = xy + shifted( x * *d, pos++ );
+
+            BOOST_CHECK( (fx * fy).to_int_list() == xy );
+        }
+
+        for ( int i=0; i < 200; i++ ) {
+            //
+            // multiplication against native 64-bit math
+            //
+            unsigned int a = std::rand();
+            unsigned int b = std::rand();
+            unsigned long long c = (unsigned long long) a * b;
+
+            auto product = FixedIntList<10>( a ) * FixedIntList<10>( b );
+            BOOST_CHECK( product.to_str() == std::to_string(c) );
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(fixedintlist_string_initialization_tests)
+{
+    BOOST_CHECK( FixedIntList<8>( "00012345" ).to_str() == "12345" );
+    BOOST_CHECK( FixedIntList<8>( "0" ).to_str() == "0" );
+    BOOST_CHECK( FixedIntList<3>( "0000999" ).to_str() == "999" );
+
+    BOOST_CHECK_THROW( FixedIntList<3> f( "1000" ), std::out_of_range );
+    BOOST_CHECK_THROW( FixedIntList<8> f( "12a45" ), std::invalid_argument );
+    BOOST_CHECK_THROW( FixedIntList<8> f( "" ), std::invalid_argument );
+}
+
+
+
+BOOST_AUTO_TEST_CASE(fixedintlist_karatsuba_tests)
+{
+    {   //
+        // everything here is worked out by the compiler
+        //
+        constexpr FixedIntList<40> m ( "1000000000000000000000000000000000000007" ); // 10^39 + 7
+        constexpr auto m2 = karatsuba( m, m );                                      // 10^78 + 14*10^39 + 49
+
+        static_assert( m2 == m * m );
+        static_assert( m2.size() == 79 );
+        static_assert( m2.digit(78) == 1 );
+        static_assert( m2.digit(40) == 1 && m2.digit(39) == 4 );
+        static_assert( m2.digit(1)  == 4 && m2.digit(0)  == 9 );
+
+        constexpr FixedIntList<3> small ( 999 );
+        static_assert( karatsuba( small, m ) == small * m );
+        static_assert( karatsuba( small, small ) == FixedIntList<6>( 998001 ) );
+        static_assert( (m - FixedIntList<1>( 7 )).size() == 40 );
+        static_assert( (m + m).digit(0) == 4 && (m + m).digit(1) == 1 );
+
+        BOOST_CHECK( m2.to_str() == ( m * m ).to_str() );
+    }
+
+    {   //
+        // random values against the schoolbook kernel
+        //
+        for ( int i=0; i < 100; i++ ) {
+            FixedIntList<100> x( random_int_list( 1 + std::rand() % 100 ) );
+            FixedIntList<100> y( random_int_list( 1 + std::rand() % 100 ) );
+            BOOST_CHECK( karatsuba( x, y ) == x * y );
+
+            FixedIntList<37> z( random_int_list( 1 + std::rand() % 37 ) );
+            BOOST_CHECK( karatsuba( x, z ) == x * z );
+        }
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
@@ -0,0 +1,351 @@
+//
+// FixedIntList.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class template for fixed-capacity integer list type with inline (stack)
+// storage; FixedIntList<64> holds any value of up to 64 decimal digits, and the
+// add/subtract/multiply kernels are specialized at compile time for that size.
+//
+// Everything that doesn't produce an IntList or std::string is constexpr, so
+// constants and their products can be computed by the compiler:
+//
+//     constexpr FixedIntList<40> m ("1000000000000000000000000000000000000007");
+//     constexpr auto m2 = karatsuba(m, m);
+//
+#ifndef __fixed_int_list_h
+#define __fixed_int_list_h
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "IntList.h"
+
+// *******************************************************************************
+// fixed_int_list_static_for
+// *******************************************************************************
+//
+// call f(std::integral_constant<std::size_t, I>{}) for every I in [0,N); the
+// loop is expanded at compile time, so every index is a constant.
+//
+// *******************************************************************************
+//
+template<std::size_t N, typename F>
+constexpr void fixed_int_list_static_for( F&& f )
+{
+    [&]<std::size_t... I>( std::index_sequence<I...> ) {
+        ( f( std::integral_constant<std::size_t, I>{} ), ... );
+    }( std::make_index_sequence<N>{} );
+}
+
+
+
+template<std::size_t N>
+class FixedIntList
+//
+// A non-negative integer of at most N decimal digits
+//
+{
+    static_assert( N > 0, "FixedIntList needs room for at least one digit" );
+
+public:
+    // list implementation type
+    using value_type = IntList::value_type;
+    static constexpr std::size_t capacity = N;
+
+private:
+    // fixed implementation (lsd first, zero-padded up to capacity)
+    std::array<value_type, N> d {};
+
+    template<std::size_t> friend class FixedIntList;
+
+public:
+    // constructors
+    constexpr FixedIntList() = default;                         // init to zero
+    constexpr FixedIntList( unsigned int n );                   // init by unsigned int
+    explicit constexpr FixedIntList( std::string_view s );      // init by decimal string (msd first)
+    explicit FixedIntList( const IntList& il );                 // init by (dense) integer list
+
+    template<std::size_t M> requires ( M <= N )
+    constexpr FixedIntList( const FixedIntList<M>& that )       // widen a smaller one
+    {
+        std::copy( that.d.begin(), that.d.end(), d.begin() );
+    }
+
+    template<std::size_t M> requires ( M > N )
+    explicit constexpr FixedIntList( const FixedIntList<M>& that ) // narrow a bigger one (if it fits)
+    {
+        if ( that.size() > N )
+            throw std::out_of_range( std::string("value does not fit in ") + std::to_string(N) + " digits" );
+        std::copy( that.d.begin(), that.d.begin() + N, d.begin() );
+    }
+
+    // digit at the specified power of 10 (no range check; pos must be < N)
+    constexpr value_type digit( std::size_t pos ) const { return d[pos]; }
+    constexpr value_type& digit( std::size_t pos ) { return d[pos]; }
+
+    // number of significant digits (as IntList::size() would report it)
+    constexpr std::size_t size() const
+    {
+        std::size_t n = N;
+        while ( n > 1 && d[n-1] == 0 )
+            --n;
+        return n;
+    }
+
+    // conversions back out
+    IntList to_int_list() const;
+    std::string to_str() const;
+
+    // numeric comparison (compare from the msd down)
+    constexpr std::strong_ordering operator<=>( const FixedIntList& that ) const
+    {
+        for ( std::size_t i = N; i-- > 0; )
+            if ( d[i] != that.d[i] )
+                return d[i] <=> that.d[i];
+        return std::strong_ordering::equal;
+    }
+    constexpr bool operator==( const FixedIntList& ) const = default;
+};
+
+
+
+// ===============================================================================
+// class FixedIntList constructors
+// ===============================================================================
+
+template<std::size_t N>
+constexpr FixedIntList<N>::FixedIntList( unsigned int n )
+{
+    for ( std::size_t i = 0; n > 0; ++i, n /= 10 ) {
+        if ( i == N )
+            throw std::out_of_range( std::string("value does not fit in ") + std::to_string(N) + " digits" );
+        d[i] = n % 10;
+    }
+}
+
+template<std::size_t N>
+constexpr FixedIntList<N>::FixedIntList( std::string_view s )
+{
+    if ( s.empty() )
+        throw std::invalid_argument( "empty string is not allowed" );
+
+    std::size_t pos = 0;
+    for ( auto c = s.rbegin(); c != s.rend(); ++c, ++pos ) {
+        if ( *c < '0' || *c > '9' )
+            throw std::invalid_argument( std::string("'") + *c + "' is not a valid decimal digit" );
+        if ( pos < N )
+            d[pos] = *c - '0';
+        else if ( *c != '0' )
+            throw std::out_of_range( std::string("value does not fit in ") + std::to_string(N) + " digits" );
+    }
+}
+
+template<std::size_t N>
+FixedIntList<N>::FixedIntList( const IntList& il )
+{
+    if ( il.size() > N )
+        throw std::out_of_range( std::string("value does not fit in ") + std::to_string(N) + " digits" );
+
+    std::copy( il.crbegin(), il.crend(), d.begin() );
+}
+
+
+
+// ===============================================================================
+// class FixedIntList methods
+// ===============================================================================
+
+template<std::size_t N>
+IntList FixedIntList<N>::to_int_list() const
+{
+    std::vector<value_type> digits( d.rend() - size(), d.rend() ); // msd first
+    return IntList( digits );
+}
+
+template<std::size_t N>
+std::string FixedIntList<N>::to_str() const
+{
+    std::string str( size(), '0' );
+    std::transform( d.rend() - str.size(), d.rend(), str.begin(), [](value_type v) { return char('0' + v); } );
+    return str;
+}
+
+
+
+// ===============================================================================
+// FixedIntList operators
+// ===============================================================================
+
+// *******************************************************************************
+// FixedIntList addition operator (+)
+// *******************************************************************************
+//
+// unrolled ripple-carry add; the result has room for the final carry.
+//
+// *******************************************************************************
+//
+template<std::size_t A, std::size_t B>
+constexpr FixedIntList<std::max(A,B)+1> operator+( const FixedIntList<A>& a, const FixedIntList<B>& b )
+{
+    FixedIntList<std::max(A,B)+1> sum;
+    unsigned int carry = 0;
+
+    fixed_int_list_static_for<std::max(A,B)>( [&]( auto i ) {
+        unsigned int digit_sum = carry;
+        if constexpr ( i < A ) digit_sum += a.digit(i);
+        if constexpr ( i < B ) digit_sum += b.digit(i);
+        carry = digit_sum >= 10;
+        sum.digit(i) = digit_sum - (carry ? 10 : 0);
+    } );
+    sum.digit(std::max(A,B)) = carry;
+
+    return sum;
+}
+
+
+
+// *******************************************************************************
+// FixedIntList subtraction operator (-)
+// *******************************************************************************
+//
+// unrolled ripple-borrow subtract; a must be >= b.
+//
+// *******************************************************************************
+//
+template<std::size_t A, std::size_t B>
+constexpr FixedIntList<A> operator-( const FixedIntList<A>& a, const FixedIntList<B>& b )
+{
+    FixedIntList<A> diff;
+    int borrow = 0;
+
+    fixed_int_list_static_for<std::max(A,B)>( [&]( auto i ) {
+        int d = -borrow;
+        if constexpr ( i < A ) d += int( a.digit(i) );
+        if constexpr ( i < B ) d -= int( b.digit(i) );
+        borrow = d < 0;
+        if constexpr ( i < A ) diff.digit(i) = d + (borrow ? 10 : 0);
+    } );
+
+    if ( borrow )
+        throw std::invalid_argument( "a (" + a.to_str() + ") must be >= (" + b.to_str() + ")" );
+
+    return diff;
+}
+
+
+
+// *******************************************************************************
+// FixedIntList multiplication operator (*)
+// *******************************************************************************
+//
+// Schoolbook product (at these sizes it beats Karatsuba's extra additions):
+// every digit pair is multiplied into a wide column without carrying, then one
+// unrolled pass resolves the column carries. Columns top out at 81*min(A,B),
+// which is nowhere near overflowing an unsigned int.
+//
+// NOTE that the A*B multiply-adds are left as loops with compile-time trip
+// counts rather than expanded with fixed_int_list_static_for; the compiler
+// vectorizes those, and that measured about twice as fast as full expansion.
+//
+// *******************************************************************************
+//
+template<std::size_t A, std::size_t B>
+constexpr FixedIntList<A+B> operator*( const FixedIntList<A>& a, const FixedIntList<B>& b )
+{
+    std::array<unsigned int, A+B> columns {};
+
+    for ( std::size_t i = 0; i < A; ++i ) {
+        const unsigned int ai = a.digit(i);
+        for ( std::size_t j = 0; j < B; ++j )
+            columns[i+j] += ai * b.digit(j);
+    }
+
+    FixedIntList<A+B> product;
+    unsigned int carry = 0;
+    fixed_int_list_static_for<A+B>( [&]( auto k ) {
+        unsigned int column = columns[k] + carry;
+        carry = column / 10;
+        product.digit(k) = column % 10;
+    } );
+
+    return product;
+}
+
+
+
+// *******************************************************************************
+// karatsuba (fixed-capacity)
+// *******************************************************************************
+//
+// Karatsuba multiplication over FixedIntLists, usable at compile time. The
+// recursion is on the (compile-time) capacities: split N digits into a low
+// half of h = ceil(N/2) and a high half of N-h, recurse on the three half-size
+// products, and fall back to the schoolbook operator* once the halves are no
+// bigger than fixed_karatsuba_cutoff digits.
+//
+// *******************************************************************************
+//
+inline constexpr std::size_t fixed_karatsuba_cutoff = 32;
+
+// add v * 10^k into acc (which must have room for the result)
+template<std::size_t R, std::size_t S>
+constexpr void fixed_int_list_add_shifted( FixedIntList<R>& acc, const FixedIntList<S>& v, std::size_t k )
+{
+    unsigned int carry = 0;
+    for ( std::size_t i = 0; k+i < R && (i < S || carry != 0); ++i ) {
+        unsigned int digit_sum = acc.digit(k+i) + (i < S ? v.digit(i) : 0) + carry;
+        carry = digit_sum >= 10;
+        acc.digit(k+i) = digit_sum - (carry ? 10 : 0);
+    }
+}
+
+template<std::size_t N>
+constexpr FixedIntList<2*N> fixed_karatsuba( const FixedIntList<N>& x, const FixedIntList<N>& y )
+{
+    if constexpr ( N <= fixed_karatsuba_cutoff )
+        return x * y;
+    else {
+        constexpr std::size_t h = N - N/2;  // take the ceil; lower half is the bigger one
+
+        FixedIntList<h> a_lo, c_lo;
+        FixedIntList<h> a_hi, c_hi;   // (N-h <= h digits, so these fit too)
+        for ( std::size_t i = 0; i < h; ++i ) {
+            a_lo.digit(i) = x.digit(i);
+            c_lo.digit(i) = y.digit(i);
+        }
+        for ( std::size_t i = h; i < N; ++i ) {
+            a_hi.digit(i-h) = x.digit(i);
+            c_hi.digit(i-h) = y.digit(i);
+        }
+
+        auto s1 = fixed_karatsuba( a_hi, c_hi );                // <2h>
+        auto s2 = fixed_karatsuba( a_lo, c_lo );                // <2h>
+        auto s1xs2 = fixed_karatsuba( a_lo + a_hi, c_lo + c_hi ); // <2h+2>
+        auto s3 = s1xs2 - s1 - s2;
+
+        FixedIntList<2*N> product;
+        fixed_int_list_add_shifted( product, s2, 0   );
+        fixed_int_list_add_shifted( product, s3, h   );
+        fixed_int_list_add_shifted( product, s1, 2*h );
+        return product;
+    }
+}
+
+template<std::size_t A, std::size_t B>
+constexpr FixedIntList<A+B> karatsuba( const FixedIntList<A>& x, const FixedIntList<B>& y )
+{
+    constexpr std::size_t N = std::max(A,B);
+    return FixedIntList<A+B>( fixed_karatsuba<N>( FixedIntList<N>(x), FixedIntList<N>(y) ) );
+}
+
+#endif // __fixed_int_list_h
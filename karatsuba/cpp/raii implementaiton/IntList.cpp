@@ -25,6 +25,11 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
 
 #include "IntList.h"
 
@@ -172,11 +177,127 @@ BOOST_AUTO_TEST_CASE(intlist_vector_initialization_tests)
 
 
 
+// *******************************************************************************
+// IntList::IntList (initialize from vector, by move)
+// *******************************************************************************
+//
+// same as above, but the IntList takes over the vector's storage instead of
+// copying it (for builders that already have the digits laid out).
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// ------------------------------------------------------------------------------- 
+//
+IntList::IntList( std::vector<value_type>&& vec ) 
+    : il( std::move(vec) )
+{
+    throw_on_invalid_min_size( il );
+    throw_on_any_invalid_value_range( il );
+    trim_leading_zeros( il );
+
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
+#endif
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_vector_move_initialization_tests)
+{
+    std::vector<IntList::value_type> v {0,0,4,2};
+    auto data = v.data();
+
+    IntList il( std::move(v) );
+    BOOST_CHECK( il == IntList(42) );
+    BOOST_CHECK( &*il.cbegin() == data );   // (trimmed in place, not copied)
+
+    BOOST_CHECK_THROW( IntList( std::vector<IntList::value_type> {} ), std::invalid_argument );
+    BOOST_CHECK_THROW( IntList( std::vector<IntList::value_type> {1,10} ), std::invalid_argument );
+}
+#endif // BUILD_UNIT_TESTS
+// ------------------------------------------------------------------------------- 
+
+
+
+// *******************************************************************************
+// IntList::IntList (initialize from trusted digits)
+// *******************************************************************************
+//
+// (private) takes the vector over as it is: the friends that use this have
+// just produced every digit themselves, so checking them one by one again
+// would be a serial pass over the whole result for nothing.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// ------------------------------------------------------------------------------- 
+//
+IntList::IntList( std::vector<value_type>&& vec, trusted_digits )
+    : il( std::move(vec) )
+{
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( !il.empty() );
+    BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
+#endif
+}
+// ------------------------------------------------------------------------------- 
+
+
+
+// *******************************************************************************
+// Machine-word powers of ten
+// *******************************************************************************
+//
+// Every power of ten a 64-bit word holds, for sizing and converting machine
+// integers (worked out at compile time, so there's nothing to build or lock).
+//
+static constexpr std::uint64_t word_powers_of_ten[] = {
+    1ULL,                 10ULL,                 100ULL,                 1000ULL,
+    10000ULL,             100000ULL,             1000000ULL,             10000000ULL,
+    100000000ULL,         1000000000ULL,         10000000000ULL,         100000000000ULL,
+    1000000000000ULL,     10000000000000ULL,     100000000000000ULL,     1000000000000000ULL,
+    10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL };
+
+// decimal digits in n (1 for 0): the bit width gives the count to within one
+// (1233/4096 being just over log10(2)), and the table settles which
+static unsigned word_digits( std::uint64_t n )
+{
+    unsigned t = ( std::bit_width( n ) * 1233 ) >> 12;
+    return n == 0 ? 1 : t + ( n >= word_powers_of_ten[t] );
+}
+
+// n's lowest 'digits' digits into out[0..digits), msd first
+static void write_word_digits( std::uint64_t n, IntList::value_type* out, unsigned long digits )
+{
+    for ( auto i = digits; i-- > 0; n /= 10 )
+        out[i] = n % 10;
+}
+
+// the value of digits il in n, if it's no bigger than max
+static bool word_value( const std::vector<IntList::value_type>& il, std::uint64_t max, std::uint64_t& n )
+{
+    if ( il.size() > word_digits( max ) )
+        return false;
+
+    n = 0;
+    for ( auto d : il ) {
+        if ( n > (max - d) / 10 )
+            return false;
+        n = n*10 + d;
+    }
+    return true;
+}
+
+
+
 // *******************************************************************************
 // IntList::IntList (initialize from unsigned int value)
 // *******************************************************************************
 //
-// Construct this IntList using an unsigned integer value
+// Construct this IntList using an unsigned integer value, sized up front from
+// the powers table and filled from the lsd end.
 //
 // -------------------------------------------------------------------------------
 //                                IMPLEMENTATION
@@ -184,13 +305,8 @@ BOOST_AUTO_TEST_CASE(intlist_vector_initialization_tests)
 //
 IntList::IntList( unsigned int n ) 
 {
-    if (n==0)
-        il.insert(il.begin(),0);
-    else
-        while (n>0) {
-            il.insert(il.begin(), n%10);
-            n/=10;
-        }
+    il.resize( word_digits( n ) );
+    write_word_digits( n, il.data(), il.size() );
 
 #ifdef BUILD_UNIT_TESTS
     BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
@@ -234,6 +350,111 @@ BOOST_AUTO_TEST_CASE(intlist_unsigned_int_initialization_tests)
         BOOST_ASSERT( il1 == il2 );
         BOOST_ASSERT( il1 != il3 );
     }
+
+    {   //
+        // every digit count, either side of each power of ten
+        //
+        for ( unsigned int p = 1; p <= 1000000000; p *= 10 )
+            for ( unsigned int n : { p-1, p, p+1 } )
+                BOOST_CHECK( IntList( n ).to_str() == std::to_string( n ) );
+        BOOST_CHECK( IntList( UINT_MAX ).to_str() == std::to_string( UINT_MAX ) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// ------------------------------------------------------------------------------- 
+
+
+
+// *******************************************************************************
+// IntList::IntList (initialize from 64- or 128-bit unsigned value)
+// *******************************************************************************
+//
+// Anything that fits a 64-bit word is done like an unsigned int. Past that,
+// the value is cut into 19-digit words (the most 10^19 leaves room for) by
+// dividing by 10^19, at most twice, and each word is written into its own
+// stretch of digits.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// ------------------------------------------------------------------------------- 
+//
+void IntList::assign_wide( unsigned __int128 n )
+{
+    if ( n <= UINT64_MAX ) {
+        il.resize( word_digits( std::uint64_t( n ) ) );
+        write_word_digits( std::uint64_t( n ), il.data(), il.size() );
+        return;
+    }
+
+    const std::uint64_t chunk = word_powers_of_ten[19];
+    std::uint64_t words[3];             // (lsw first; 2^128 has 39 digits)
+    unsigned count = 0;
+    for ( ; n > 0; n /= chunk )
+        words[count++] = std::uint64_t( n % chunk );
+
+    il.resize( word_digits( words[count-1] ) + 19*(count-1) );
+    auto out = il.data() + il.size();
+    for ( unsigned i = 0; i+1 < count; ++i ) {
+        out -= 19;
+        write_word_digits( words[i], out, 19 );
+    }
+    write_word_digits( words[count-1], il.data(), out - il.data() );
+
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
+#endif
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_wide_unsigned_initialization_tests)
+{
+    {   //
+        // 64-bit values, at the edges
+        //
+        BOOST_CHECK( IntList( std::uint64_t(0) ).to_str() == "0" );
+        BOOST_CHECK( IntList( std::uint64_t(UINT_MAX) + 1 ).to_str() == "4294967296" );
+        BOOST_CHECK( IntList( UINT64_MAX ).to_str() == "18446744073709551615" );
+        BOOST_CHECK( IntList( 9999999999999999999ULL ).to_str() == "9999999999999999999" );
+        BOOST_CHECK( IntList( 10000000000000000000ULL ).to_str() == "10000000000000000000" );
+
+        // (a size_t isn't cut down to an unsigned int on the way in)
+        std::size_t big = std::size_t(1) << 40;
+        IntList il = big;
+        BOOST_CHECK( il.to_str() == "1099511627776" );
+    }
+
+    {   //
+        // 128-bit values: one, two and three 19-digit words' worth
+        //
+        unsigned __int128 max = ~(unsigned __int128)0;
+        BOOST_CHECK( IntList( max ).to_str() == "340282366920938463463374607431768211455" );
+        BOOST_CHECK( IntList( (unsigned __int128)UINT64_MAX + 1 ).to_str() == "18446744073709551616" );
+
+        unsigned __int128 p = 1;
+        for ( int i = 0; i < 38; ++i )
+            p *= 10;
+        BOOST_CHECK( IntList( p ).to_str() == "1" + std::string( 38, '0' ) );
+        BOOST_CHECK( IntList( p - 1 ).to_str() == std::string( 38, '9' ) );
+
+        // 10^19 * w + 5 (with the low word mostly zeros)
+        unsigned __int128 w = 123456789;
+        BOOST_CHECK( IntList( w * 10000000000000000000ULL + 5 ).to_str() == "123456789" "0000000000000000005" );
+    }
+
+    {   //
+        // random values against std::to_string
+        //
+        std::srand(time(nullptr));
+        for ( int i = 0; i < 1000; ++i ) {
+            std::uint64_t n = ( std::uint64_t( std::rand() ) << 33 ) ^ ( std::uint64_t( std::rand() ) << 11 ) ^ std::rand();
+            n >>= std::rand() % 64;
+            BOOST_CHECK( IntList( n ).to_str() == std::to_string( n ) );
+        }
+    }
 }
 #endif // BUILD_UNIT_TESTS
 // ------------------------------------------------------------------------------- 
@@ -254,8 +475,9 @@ BOOST_AUTO_TEST_CASE(intlist_unsigned_int_initialization_tests)
 // ------------------------------------------------------------------------------- 
 //
 IntList::IntList( IntList&& il )
-    : il{std::move(il.il)}
+    : il{std::move(il.il)}, cached_hash{il.cached_hash.load( std::memory_order_relaxed )}
 {
+    il.forget_hash();
 #ifdef BUILD_UNIT_TESTS
     BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
 #endif
@@ -281,6 +503,71 @@ BOOST_AUTO_TEST_CASE(IntList_move_constructor_tests)
 
 
 
+// *******************************************************************************
+// IntList::IntList (initialize from decimal string)
+// *******************************************************************************
+//
+// Construct this IntList from a string of decimal digits, msd first (leading
+// zeros are fine, and trimmed); anything that isn't a digit is rejected.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// ------------------------------------------------------------------------------- 
+//
+IntList::IntList( std::string_view s ) 
+{
+    if ( s.empty() )
+        throw std::invalid_argument( "empty string is not allowed" );
+
+    const char* last = s.data() + s.size();
+    const char* first = std::find_if( s.data(), last-1, []( char c ) { return c != '0'; } );
+
+    il.resize( last - first );
+    const char* stop = parse_digits( first, last, il.data() );
+    if ( stop != last )
+        throw std::invalid_argument( std::string("'") + *stop + "' is not a valid decimal digit" );
+
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( IntList::is_zero_trimmed(*this) );
+#endif
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_string_initialization_tests)
+{
+    BOOST_CHECK( IntList( "0" ) == IntList(0) );
+    BOOST_CHECK( IntList( "000" ) == IntList(0) );
+    BOOST_CHECK( IntList( "0061587" ) == IntList(61587) );
+    BOOST_CHECK( IntList( "4294967295" ).to_uint() == UINT_MAX );
+
+    {   //
+        // long enough to go through the 8-at-a-time path, with the bad digit
+        // in each possible spot
+        //
+        std::string digits = "31415926535897932384626433832795028841971";
+        BOOST_CHECK( IntList( digits ).to_str() == digits );
+
+        for ( std::size_t i=0; i < digits.size(); i++ )
+            for ( char bad : { '/', ':', 'a', ' ', '\0', char(0xB0), char(0xFF) } ) {
+                auto s = digits;
+                s[i] = bad;
+                BOOST_CHECK_THROW( IntList il( s ), std::invalid_argument );
+            }
+    }
+
+    BOOST_CHECK_THROW( IntList il( "" ), std::invalid_argument );
+    BOOST_CHECK_THROW( IntList il( "12a45" ), std::invalid_argument );
+    BOOST_CHECK_THROW( IntList il( "-1" ), std::invalid_argument );
+}
+#endif // BUILD_UNIT_TESTS
+// ------------------------------------------------------------------------------- 
+
+
+
 // =============================================================================== 
 // class IntList operators
 // =============================================================================== 
@@ -300,6 +587,8 @@ BOOST_AUTO_TEST_CASE(IntList_move_constructor_tests)
 IntList& IntList::operator=(IntList&& il)
 {
     this->il = std::move(il.il); // invoke std container move semantics
+    cached_hash.store( il.cached_hash.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    il.forget_hash();
 #ifdef BUILD_UNIT_TESTS
     BOOST_ASSERT( IntList::is_zero_trimmed( *this ) );
 #endif
@@ -340,6 +629,10 @@ BOOST_AUTO_TEST_CASE(Intlist_move_assignment_operator_tests)
 // Returns reference to this object's value at the specified index. Range checked.
 // Range checking will throw exception for bad indexes.
 //
+// The non-const [] can only drop the cached hash as the reference goes out,
+// so a write through a reference kept past a hash() leaves that hash stale;
+// set_digit() does the write itself, and drops the hash after it.
+//
 // *******************************************************************************
 //
 void IntList::throw_on_invalid_index( int i, const int_list_t& il) const
@@ -355,6 +648,7 @@ IntList::value_type& IntList::operator[]( int i )
     // given a valid index, offer indexed access to our number.
     // 
     throw_on_invalid_index( i, il );
+    forget_hash();      // (whatever's done through the reference)
     return il[i];
 }
 //
@@ -366,6 +660,18 @@ const IntList::value_type& IntList::operator[]( int i ) const
     return il[i]; 
 }
 //
+void IntList::set_digit( int i, value_type v )
+{
+    if ( i < 0 || std::size_t(i) >= il.size() )
+        throw std::out_of_range( "index must be >=0 and < " + std::to_string( il.size() ) );
+    throw_on_invalid_value_range( v );
+
+    il[i] = v;
+    if ( i == 0 && v == 0 )
+        trim_leading_zeros( il );
+    forget_hash();
+}
+//
 // -------------------------------------------------------------------------------
 //                             FUNCTIONALITY TESTS
 // -------------------------------------------------------------------------------
@@ -389,6 +695,21 @@ BOOST_AUTO_TEST_CASE(intlist_indexing_operator_tests)
     // verify ability to modify value
     il1[1] = 8;
     BOOST_ASSERT( il1[1] == 8 );
+
+    // ...and to set one, with the index and value both checked
+    il1.set_digit( 2, 5 );
+    BOOST_CHECK( il1 == IntList( 185u ) );
+    BOOST_CHECK_THROW( il1.set_digit( 3, 1 ), std::out_of_range );
+    BOOST_CHECK_THROW( il1.set_digit( -1, 1 ), std::out_of_range );
+    BOOST_CHECK_THROW( il1.set_digit( 0, 10 ), std::invalid_argument );
+    BOOST_CHECK( il1 == IntList( 185u ) );
+
+    // (a zero over the msd leaves a shorter number, not a leading zero)
+    il1.set_digit( 0, 0 );
+    BOOST_CHECK( il1 == IntList( 85u ) && IntList::is_zero_trimmed( il1 ) );
+    il1.set_digit( 0, 0 );
+    il1.set_digit( 0, 0 );
+    BOOST_CHECK( il1 == IntList( 0u ) && IntList::is_zero_trimmed( il1 ) );
 }
 #endif // BUILD_UNIT_TESTS
 // -------------------------------------------------------------------------------
@@ -399,6 +720,91 @@ BOOST_AUTO_TEST_CASE(intlist_indexing_operator_tests)
 // class IntList methods 
 // =============================================================================== 
 
+// *******************************************************************************
+// IntList::assign_digits
+// *******************************************************************************
+//
+// Replace this list's digits with [first,last) of another's, in the storage
+// this one already has. The leading zeros are skipped rather than copied and
+// trimmed, and from may be this list itself.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void IntList::assign_digits( const IntList& from, unsigned long first, unsigned long last )
+{
+    if ( first > last || last > from.size() )
+        throw std::out_of_range( "digits [" + std::to_string( first ) + "," + std::to_string( last ) +
+                                 ") aren't all in a list of " + std::to_string( from.size() ) );
+
+    while ( first + 1 < last && from.il[first] == 0 )
+        ++first;
+
+    if ( first == last )
+        il.assign( 1, 0 );
+    else if ( &from == this ) {
+        il.erase( il.begin() + last, il.end() );
+        il.erase( il.begin(), il.begin() + first );
+    }
+    else
+        il.assign( from.il.begin() + first, from.il.begin() + last );
+    forget_hash();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_assign_digits_tests)
+{
+    IntList from { 1,2,0,0,4,5 };
+
+    {   //
+        // a run of digits, trimmed, with empty runs and runs of zeros as zero
+        //
+        IntList il( 9 );
+        il.assign_digits( from, 0, 2 );
+        BOOST_CHECK( il == IntList( 12u ) );
+        il.assign_digits( from, 2, 6 );
+        BOOST_CHECK( il == IntList( 45u ) && IntList::is_zero_trimmed( il ) );
+        il.assign_digits( from, 2, 4 );
+        BOOST_CHECK( il == IntList( 0u ) && il.size() == 1 );
+        il.assign_digits( from, 3, 3 );
+        BOOST_CHECK( il == IntList( 0u ) && il.size() == 1 );
+
+        BOOST_CHECK_THROW( il.assign_digits( from, 2, 7 ), std::out_of_range );
+        BOOST_CHECK_THROW( il.assign_digits( from, 4, 3 ), std::out_of_range );
+    }
+
+    {   //
+        // in the storage it already had, and out of itself
+        //
+        IntList il( 0 );
+        il.reserve( 100 );
+        il.assign_digits( from, 0, 6 );
+        BOOST_CHECK( il == IntList( 120045u ) && digit_capacity( il ) >= 100 );
+
+        il.assign_digits( il, 1, 5 );
+        BOOST_CHECK( il == IntList( 2004u ) && digit_capacity( il ) >= 100 );
+    }
+
+    {   //
+        // the hash goes with the old digits
+        //
+        IntList il( 12u );
+        auto h = il.hash();
+        il.assign_digits( from, 4, 6 );
+        BOOST_CHECK( il.hash() == IntList( 45u ).hash() && il.hash() != h );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+
 // *******************************************************************************
 // IntList::clone
 // *******************************************************************************
@@ -629,6 +1035,7 @@ void IntList::push_back(value_type n)
     IntList::throw_on_invalid_value_range( n );
     il.push_back( n );
     IntList::trim_leading_zeros( il );
+    forget_hash();
 }
 //
 // -------------------------------------------------------------------------------
@@ -951,44 +1358,10 @@ BOOST_AUTO_TEST_CASE(intlist_comparison_operator_tests)
 //
 // *******************************************************************************
 //
-IntList operator+(const IntList& a, const IntList& b)
-{
-    std::vector<IntList::value_type> sum;
-
-    unsigned int digit_sum = 0;
-    unsigned int ones_sum  = 0;
-    unsigned int carry     = 0;
-
-    // Find the respective (possibly different) indices of each summand's least
-    // significant digit, and walk towards the greatest significant digit (aka
-    // towards index 0). Again, if the two summands are of different lengths,
-    // they will get there at different times, and the one left decrementing
-    // alone in that case will be partnered with a '0' during the per-digit sum.
-
-    int i = a.size() - 1;
-    int j = b.size() - 1;
-    int digits_to_process = std::max(a.size(), b.size());
-
-    while ( digits_to_process-- > 0 ) {
-
-        digit_sum = ( (i >= 0) ? a[i--] : 0 )
-                  + ( (j >= 0) ? b[j--] : 0 )
-                  + carry;
-        ones_sum = digit_sum%10;
-        carry    = digit_sum/10;
-
-        sum.push_back(ones_sum);
-    }
-
-    // don't forget about the last carry!
-    if (carry != 0)
-        sum.push_back(carry);
-
-    // msd should be at index-0
-    std::reverse( sum.begin(), sum.end() );
-
-    return sum;
-}
+// Defined in IntListExpr.h; a + b adds them right away (digit-by-digit from
+// the lsd, carrying as it goes) and returns the sum. In a + b + c the second
+// + adds c into the sum the first one made, rather than building another; to
+// fuse the chain into one pass as well, start it with lazy(): lazy(a) + b + c.
 //
 // -------------------------------------------------------------------------------
 //                             FUNCTIONALITY TESTS
@@ -1107,69 +1480,11 @@ BOOST_AUTO_TEST_CASE(intlist_addition_operator_tests)
 //
 // *******************************************************************************
 //
-IntList operator-(const IntList& a, const IntList& b)
-{   //
-    // make sure a>=b
-    //
-    if (!(a >= b)) {
-        std::stringstream error_msg_ss;
-        error_msg_ss << "a (" << a.to_str() << ") must be >= (" << b.to_str() << ")";
-        throw std::invalid_argument(error_msg_ss.str());
-    }
-
-    //
-    // make a note of our sizes; find the biggest
-    //
-    auto a_size = a.size();
-    auto b_size = b.size();
-    auto [max_size, min_size] = a_size >= b_size 
-                              ? std::make_pair(a_size, b_size) 
-                              : std::make_pair(b_size, a_size);
-
-#ifdef BUILD_UNIT_TESTS
-    BOOST_ASSERT( a_size >= b_size); // we expect only non-negative differences
-#endif
-
-    //
-    // make copies of our inputs since we're going to be changing them during
-    // the calculation
-    //
-    auto ac = a.clone();
-    auto bc = b.clone();
-
-    std::vector<IntList::value_type> diff;
-
-    auto ai = ac.rbegin();                           // we're going to use iterators to subtract digit-by-digit so we can handle
-    auto bi = bc.rbegin();                           // as arbitrarily-lengthed numbers as the computer an throw at us...
-
-    for ( ; ai != ac.rend() ; ++ai ) {               // 'a' should be same size as 'b' or bigger, so use it to control full loop
-        int bz;
-        if (bi!=bc.rend()) {                         // 'b' may be shorter than 'a'; if it is we'll have to "fake" zeros for it
-            bz = *bi;                                // once we run out of digits...
-            ++bi;
-        }
-        else
-            bz = 0;
-        int d = *ai - bz;                            // subtract least-significant unprocessed digit in 'a' from counterpart in 'b'
-#ifdef BUILD_UNIT_TESTS
-        BOOST_ASSERT( -10 <= d && d < 10 );          // (we at most have a single digit minus another single digit)
-#endif
-        if (d < 0) {                                 // if a's digit was bigger than b's...
-            auto brwi = ai+1;                        // get ready to start ripple-borrowing at the NEXT bigger digit...
-            for ( ; *brwi == 0; ++brwi ) {           // while the next-bigger digit of 'a' is 0...
-#ifdef BUILD_UNIT_TESTS
-                BOOST_ASSERT( brwi != ac.rend() );   // (we always expect a >= b, so the final 'a' digit shoudl never be 0) 
-#endif
-                *brwi = 9;                           // make the 0 into a 9
-            }
-            *brwi -= 1;                              // we've finally reached a non-zero digit to "borrow" from, so borrow
-            d += 10;                                 // add the borrowed 10 from the next digit to the underwater value
-        }
-        diff.insert(diff.begin(),d);                 // we are big endian, so push more significant values in at the front
-    }
-
-    return IntList(diff);                            // move our calculated difference out to the caller
-}
+// Defined in IntListExpr.h; a - b checks that a >= b, then subtracts right
+// away (borrowing as it goes) and returns the difference (in a - b - c, the
+// second step works in the first one's result). A chain started with lazy()
+// (lazy(a) - b - c) is fused into one pass, and only checked for going
+// negative once it's evaluated.
 //
 // -------------------------------------------------------------------------------
 //                             FUNCTIONALITY TESTS
@@ -1288,35 +1603,231 @@ BOOST_AUTO_TEST_CASE(intlist_subtraction_operator_tests)
 
 
 // *******************************************************************************
-// A unsigned int representation of the contents of integer list (if it fits)
+// IntList fused expressions (+, -, shifted, scalar *)
 // *******************************************************************************
 //
-// Just scale out and add up powers of 10.
+// Chains of the arithmetic operators started with lazy() are evaluated in a
+// single pass when they are assigned to an IntList (the operators on plain
+// IntLists evaluate straight away). See IntListExpr.h for definitions.
 //
 // *******************************************************************************
 //
-unsigned int IntList::to_uint() const
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_fused_expression_tests)
 {
-    IntList uint_max(UINT_MAX);
-    if (*this <=> uint_max > 0) {
-        std::string msg = "to_uint() integer must be no larger than UINT_MAX (" + std::to_string( UINT_MAX ) + ")";
-        throw std::out_of_range( msg );
+    {   //
+        // chains of sums and differences
+        //
+        IntList a(1000);
+        IntList b(1);
+        IntList c(250);
+
+        IntList abc = lazy(a) + b + c;
+        BOOST_CHECK( abc == IntList(1251) );
+
+        IntList s3 = lazy(a) - b - c;
+        BOOST_CHECK( s3 == IntList(749) );
+
+        BOOST_CHECK( lazy(a) - b + c == IntList(1249) );
+        BOOST_CHECK( (lazy(a) + b) - (lazy(c) + c) == IntList(501) );
+        BOOST_CHECK( (lazy(a) + b) == (lazy(b) + a) );
+        BOOST_CHECK( (lazy(a) + c) > a );
+        BOOST_CHECK( a < (lazy(a) + b) );
+
+        // the plain operators give the same answers, one step at a time
+        BOOST_CHECK( a + b + c == abc );
+        BOOST_CHECK( a - b - c == s3 );
+    }
+
+    {   //
+        // intermediate values may dip below zero as long as the total doesn't
+        // (only in a lazy chain; the plain subtraction checks every step)
+        //
+        IntList a(5);
+        IntList b(9);
+        IntList c(7);
+        IntList abc = lazy(a) - b + c;
+        BOOST_CHECK( abc == IntList(3) );
+        BOOST_CHECK_THROW( a - b + c, std::invalid_argument );
+
+        auto negative = lazy(a) + c - b - b;
+        BOOST_CHECK_THROW( IntList il = negative, std::invalid_argument );
+        BOOST_CHECK_THROW( a + c - b - b, std::invalid_argument );
+    }
+
+    {   //
+        // shifts and scalar multiplies
+        //
+        IntList a(12);
+        IntList b(34);
+        IntList c(56);
+
+        IntList abc = shifted(lazy(a), 4) + shifted(b, 2) + c;
+        BOOST_CHECK( abc == IntList(123456) );
+        BOOST_CHECK( shifted(a, 4) + shifted(b, 2) + c == abc );
+
+        BOOST_CHECK( a * 3 == IntList(36) );
+        BOOST_CHECK( 9 * shifted(lazy(c), 1) - a == IntList(5028) );
+        BOOST_CHECK( (a * 0).to_str() == "0" );
     }
 
-    // start with the least significant digit, and add up the
-    // powers of 10. NOTE that we have to process index 0, and
-    // so the loop will fall through once we decrement into 
-    // negative index territory...
+    {   //
+        // temporaries are owned by the expression (no dangling references)
+        //
+        IntList e = lazy(IntList(999)) + IntList(1);
+        BOOST_CHECK( e.to_uint() == 1000 );
+    }
+
+    {   //
+        // the plain operators give back values, not views of their operands
+        //
+        IntList a(5);
+        IntList b(7);
+        auto s = a + b;
+        auto d = b - a;
+        a = IntList(100u);
+        b = IntList(200u);
+        IntList r = std::move(s);
+        BOOST_CHECK( r == IntList(12) );
+        BOOST_CHECK( d == IntList(2) );
+
+        auto t = a + b;
+        BOOST_CHECK( t.size() == 3 );
+        BOOST_CHECK( *t.begin() == 3 );
+        BOOST_CHECK( t.to_str() == "300" );
+        BOOST_CHECK( (a * 3).size() == 3 );
+        BOOST_CHECK( shifted(a, 2).to_str() == "10000" );
+    }
+
+    {   //
+        // a chain of the plain operators works in the one IntList its first
+        // step built (a temporary on the left is reused, not copied)
+        //
+        IntList a(999);
+        IntList b(1);
+        IntList c(250);
+
+        IntList t = a + b;
+        set_previous_index_0_data_address(t);
+        IntList u = std::move(t) - c;
+        BOOST_CHECK( u == IntList(750) );
+        BOOST_CHECK( has_same_index_0_data_address_as_previous(u) );
+
+        BOOST_CHECK( a + b + c == IntList(1250) );
+        BOOST_CHECK( a + (b + c) == IntList(1250) );
+        BOOST_CHECK( (a + b) + (c + c) == IntList(1500) );
+        BOOST_CHECK( IntList(999) + b == IntList(1000) );           // (carried out of the msd)
+        BOOST_CHECK( IntList(1000) - b - a == IntList(0) );         // (trimmed down to zero)
+        BOOST_CHECK( (IntList(1000) - b).to_str() == "999" );
+        BOOST_CHECK_THROW( IntList(5) - c, std::invalid_argument );
+
+        BOOST_CHECK( IntList(99) * 99 == IntList(9801) );
+        BOOST_CHECK( 3 * IntList(45) == IntList(135) );
+        BOOST_CHECK( (IntList(0) * 7).to_str() == "0" );
+        BOOST_CHECK( (IntList(45) * 0).to_str() == "0" );
+        BOOST_CHECK( IntList(7) * 4000000000u == IntList( 28000000000ULL ) );
+        BOOST_CHECK( shifted( a + b, 2 ) == IntList(100000) );
+        BOOST_CHECK( shifted( IntList(0), 5 ).to_str() == "0" );
+
+        IntList h = a + b;
+        auto before = h.hash();
+        h = std::move(h) + c;
+        BOOST_CHECK( h.hash() != before && h.hash() == IntList(1250).hash() );
+    }
+
+    {   //
+        // lazy expressions convert to IntLists wherever one is wanted
+        //
+        IntList a(12345);
+        IntList b(54321);
+        BOOST_CHECK( (lazy(a) + b).to_str() == "66666" );
+        BOOST_CHECK( (lazy(a) + b).clone() == IntList(66666) );
 
-    unsigned int sum = 0;
-    unsigned int ten_to_the_i = 1;
+        IntList e(0);
+        e = lazy(a) + b;
+        BOOST_CHECK( e == IntList(66666) );
 
-    for ( int i=il.size()-1; i>=0; --i ) {
-        sum += ten_to_the_i * il[i];
-        ten_to_the_i *= 10;
+        e = lazy(e) + e; // aliasing the target is fine; the old value is read first
+        BOOST_CHECK( e == IntList(133332) );
     }
 
-    return sum;
+    {   //
+        // or into one that's already there, keeping its storage (and zero if
+        // it goes negative)
+        //
+        IntList a(12345);
+        IntList b(54321);
+        IntList e(0);
+        e.reserve( 100 );
+        (lazy(a) + b).evaluate_into( e );
+        BOOST_CHECK( e == IntList(66666) && digit_capacity( e ) >= 100 );
+
+        auto h = e.hash();
+        (lazy(b) - a).evaluate_into( e );
+        BOOST_CHECK( e == IntList(41976) && e.hash() != h );
+
+        BOOST_CHECK_THROW( (lazy(a) - b).evaluate_into( e ), std::invalid_argument );
+        BOOST_CHECK( e == IntList(0) && e.size() == 1 );
+    }
+
+    {   //
+        // double-checking random chains with c++ math
+        //
+        for ( int i=0; i < 1000; i++ ) {
+            unsigned int a = std::rand() % 1000;
+            unsigned int b = std::rand() % 1000;
+            unsigned int c = std::rand() % 1000;
+            unsigned int k = std::rand() % 4;
+            unsigned int n = std::rand() % 10;
+
+            IntList ia(a), ib(b), ic(c);
+            unsigned int expected = a * n + b * 1000 + c;
+            for ( unsigned int z=0; z < k; z++ )
+                expected *= 10;
+
+            IntList result = shifted( lazy(ia) * n + shifted(ib, 3) + ic, k );
+            BOOST_CHECK( result.to_uint() == expected );
+            BOOST_CHECK( shifted( ia * n + shifted(ib, 3) + ic, k ) == result );
+        }
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// A unsigned int (or 64-bit) representation of the contents of integer list (if
+// it fits)
+// *******************************************************************************
+//
+// Horner's rule from the msd, checking each step against the maximum before
+// taking it (so there's no big maximum IntList to build and compare against).
+//
+// *******************************************************************************
+//
+unsigned int IntList::to_uint() const
+{
+    std::uint64_t n;
+    if ( !word_value( il, UINT_MAX, n ) ) {
+        std::string msg = "to_uint() integer must be no larger than UINT_MAX (" + std::to_string( UINT_MAX ) + ")";
+        throw std::out_of_range( msg );
+    }
+    return n;
+}
+//
+std::uint64_t IntList::to_u64() const
+{
+    std::uint64_t n;
+    if ( !word_value( il, UINT64_MAX, n ) ) {
+        std::string msg = "to_u64() integer must be no larger than UINT64_MAX (" + std::to_string( UINT64_MAX ) + ")";
+        throw std::out_of_range( msg );
+    }
+    return n;
 }
 //
 // -------------------------------------------------------------------------------
@@ -1342,6 +1853,24 @@ BOOST_AUTO_TEST_CASE(intlist_to_uint_tests)
     il_too_big.push_back(9); // now we've done it
     BOOST_CHECK_THROW( unsigned int val = il_too_big.to_uint(), std::out_of_range);
 
+    {   //
+        // right at the edges
+        //
+        BOOST_CHECK( IntList( "4294967295" ).to_uint() == UINT_MAX );
+        BOOST_CHECK_THROW( IntList( "4294967296" ).to_uint(), std::out_of_range );
+        BOOST_CHECK_THROW( IntList( "5000000000" ).to_uint(), std::out_of_range );
+
+        BOOST_CHECK( IntList( "0" ).to_u64() == 0 );
+        BOOST_CHECK( IntList( "18446744073709551615" ).to_u64() == UINT64_MAX );
+        BOOST_CHECK( IntList( "9999999999999999999" ).to_u64() == 9999999999999999999ULL );
+        BOOST_CHECK_THROW( IntList( "18446744073709551616" ).to_u64(), std::out_of_range );
+        BOOST_CHECK_THROW( IntList( "20000000000000000000" ).to_u64(), std::out_of_range );
+        BOOST_CHECK_THROW( IntList( "100000000000000000000" ).to_u64(), std::out_of_range );
+
+        for ( std::uint64_t n = 1; n < UINT64_MAX / 7; n = n*7 + 3 )
+            BOOST_CHECK( IntList( n ).to_u64() == n );
+    }
+
     {   //
         // double-checking random values with c++ math
         //
@@ -1372,18 +1901,353 @@ BOOST_AUTO_TEST_CASE(intlist_to_uint_tests)
 
 
 
+// *******************************************************************************
+// IntList::hash
+// *******************************************************************************
+//
+// Eight independent 64-bit lanes over 64-byte stripes of the digit storage
+// (16 digits). Each word is xored with a per-lane key, and the two halves of
+// that are multiplied together (a 32x32->64 multiply, which SIMD units do
+// several of at once, and the compiler vectorizes the stripe loop to them);
+// the word itself goes into the neighbouring lane too, so no input is lost to
+// a zero half. The lanes and the tail are folded together and avalanched at
+// the end. Not cryptographic; it's for hash tables and caches.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::size_t IntList::hash() const
+{
+    auto cached = cached_hash.load( std::memory_order_relaxed );
+    if ( cached != 0 )
+        return cached;
+
+    constexpr std::uint64_t k1 = 0x9E3779B97F4A7C15ULL;
+    constexpr std::uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr std::uint64_t keys[8] = { 0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL,
+                                        0x1F67B3B7A4A44072ULL, 0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL,
+                                        0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL };
+
+    std::uint64_t lanes[8] = { k1, k2, k1 ^ k2, ~k1, ~k2, k1 + k2, k1 * 3, k2 * 5 };
+
+    const char* p = reinterpret_cast<const char*>( il.data() );
+    std::size_t n = il.size() * sizeof(value_type);
+
+    for ( ; n >= 64; p += 64, n -= 64 ) {
+        std::uint64_t words[8];
+        std::memcpy( words, p, 64 );
+        for ( int l = 0; l < 8; ++l ) {
+            auto keyed = words[l] ^ keys[l];
+            lanes[l] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+        }
+        for ( int l = 0; l < 8; ++l )
+            lanes[l ^ 1] += words[l];
+    }
+
+    auto mix = []( std::uint64_t h, std::uint64_t w ) { return std::rotl( (h ^ w) * k2, 31 ) * k1; };
+
+    std::uint64_t h = il.size() * k1;
+    for ( auto lane : lanes )
+        h = mix( h, lane );
+    for ( ; n >= 8; p += 8, n -= 8 ) {
+        std::uint64_t w;
+        std::memcpy( &w, p, 8 );
+        h = mix( h, w );
+    }
+    if ( n > 0 ) {
+        std::uint64_t w = 0;
+        std::memcpy( &w, p, n );
+        h = mix( h, w );
+    }
+
+    h ^= h >> 33; h *= k2;
+    h ^= h >> 29; h *= k1;
+    h ^= h >> 32;
+
+    if ( h == 0 )
+        h = 1;      // (0 means "not worked out yet")
+    cached_hash.store( h, std::memory_order_relaxed );
+    return h;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_hash_tests)
+{
+    {   //
+        // equal values hash equal, however they were made
+        //
+        IntList a( 1234567890u );
+        IntList b( std::string_view( "0001234567890" ) );
+        IntList c = b.clone();
+        BOOST_CHECK( a.hash() == b.hash() );
+        BOOST_CHECK( std::hash<IntList>{}( a ) == c.hash() );
+
+        std::string long_digits( 1000, '7' );
+        BOOST_CHECK( IntList( long_digits ).hash() == IntList( long_digits ).hash() );
+    }
+
+    {   //
+        // no collisions over a pile of nearby values (every length, so every
+        // tail case of the stripes)
+        //
+        std::unordered_set<std::size_t> seen;
+        std::string digits;
+        for ( int len = 1; len <= 200; ++len ) {
+            digits.push_back( char( '1' + len % 9 ) );
+            for ( char last = '0'; last <= '9'; ++last ) {
+                digits.back() = last;
+                if ( len == 1 && last == '0' )
+                    continue;
+                seen.insert( IntList( digits ).hash() );
+            }
+        }
+        BOOST_CHECK( seen.size() == 200*10 - 1 );
+    }
+
+    {   //
+        // changes drop the cached hash
+        //
+        IntList a { 1,2,3 }, b { 1,2,4 };
+        auto h = a.hash();
+        a[2] = 4;
+        BOOST_CHECK( a.hash() == b.hash() && a.hash() != h );
+
+        a.push_back( 5 );
+        BOOST_CHECK( a.hash() == IntList( 1245u ).hash() );
+
+        *a.begin() = 9;
+        BOOST_CHECK( a.hash() == IntList( 9245u ).hash() );
+
+        IntList::from_chars( "777", "777" + 3, a );
+        BOOST_CHECK( a.hash() == IntList( 777u ).hash() );
+
+        a = IntList( 5u );
+        BOOST_CHECK( a.hash() == IntList( 5u ).hash() );
+
+        // set_digit drops it after the write, so hashing in between is fine
+        IntList d { 1,2,3 };
+        h = d.hash();
+        d.set_digit( 0, 7 );
+        BOOST_CHECK( d.hash() == IntList( 723u ).hash() && d.hash() != h );
+        d.hash();
+        d.set_digit( 2, 0 );
+        BOOST_CHECK( d.hash() == IntList( 720u ).hash() );
+
+        // (and a move takes it along)
+        auto big = IntList( std::string( 500, '3' ) );
+        h = big.hash();
+        IntList moved( std::move(big) );
+        BOOST_CHECK( moved.hash() == h );
+    }
+
+    {   //
+        // usable as a key
+        //
+        std::unordered_set<IntList> set;
+        set.emplace( 42u );
+        set.emplace( std::string_view( "123456789012345678901234567890" ) );
+        set.emplace( 42u );
+        BOOST_CHECK( set.size() == 2 );
+        BOOST_CHECK( set.count( IntList( 42u ) ) == 1 );
+        BOOST_CHECK( set.count( IntList( 43u ) ) == 0 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// IntList::parse_digits
+// *******************************************************************************
+//
+// The digit loop behind the string constructor and from_chars. Eight chars at a
+// time are loaded into a 64-bit word and checked together: every byte of a run
+// of ASCII digits ('0'..'9' = 0x30..0x39) has a high nibble of 3, and still has
+// one after adding 6 (which pushes 0x3A..0x3F over into 0x40..0x45). Runs that
+// pass are converted with a plain subtract loop the compiler vectorizes; the
+// first word that fails (and the ragged tail) are finished a char at a time.
+//
+// *******************************************************************************
+//
+static bool eight_digits( const char* p )
+{
+    constexpr std::uint64_t high_nibbles = 0xF0F0F0F0F0F0F0F0ULL;
+    constexpr std::uint64_t all_threes   = 0x3030303030303030ULL;
+    constexpr std::uint64_t all_sixes    = 0x0606060606060606ULL;
+
+    std::uint64_t word;
+    std::memcpy( &word, p, 8 );
+    return (word & high_nibbles) == all_threes && ((word + all_sixes) & high_nibbles) == all_threes;
+}
+//
+// (the same scan without the conversion: where the run of digits at first ends)
+//
+static const char* end_of_digits( const char* first, const char* last )
+{
+    while ( last - first >= 8 && eight_digits( first ) )
+        first += 8;
+    while ( first != last && *first >= '0' && *first <= '9' )
+        ++first;
+    return first;
+}
+//
+const char* IntList::parse_digits( const char* first, const char* last, value_type* out )
+{
+    while ( last - first >= 8 ) {
+        if ( !eight_digits( first ) )
+            break;
+
+        for ( int i = 0; i < 8; ++i )
+            out[i] = first[i] - '0';
+        first += 8;
+        out += 8;
+    }
+
+    for ( ; first != last && *first >= '0' && *first <= '9'; ++first )
+        *out++ = *first - '0';
+
+    return first;
+}
+
+
+
+// *******************************************************************************
+// IntList::from_chars
+// *******************************************************************************
+//
+// Same contract as std::from_chars for unsigned integers (no sign, no
+// whitespace, stop at the first non-digit), except that the value can't
+// overflow. The end of the digit run is found before anything's allocated, so
+// pulling one number off the front of a big buffer costs only that number.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::from_chars_result IntList::from_chars( const char* first, const char* last, IntList& value )
+{
+    const char* stop = end_of_digits( first, last );
+    if ( stop == first )
+        return { first, std::errc::invalid_argument };
+
+    const char* nonzero = std::find_if( first, stop, []( char c ) { return c != '0'; } );
+    if ( nonzero == stop )
+        --nonzero;                  // (it was all zeros; keep one)
+
+    int_list_t digits( stop - nonzero );
+    parse_digits( nonzero, stop, digits.data() );
+
+    value.il = std::move( digits );
+    value.forget_hash();
+    return { stop, std::errc() };
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_from_chars_tests)
+{
+    IntList value( 7 );
+
+    {   //
+        // stops at the first non-digit
+        //
+        std::string_view s = "000123456789012345678901234567890,42";
+        auto [ptr, ec] = IntList::from_chars( s.data(), s.data() + s.size(), value );
+        BOOST_CHECK( ec == std::errc() );
+        BOOST_CHECK( *ptr == ',' );
+        BOOST_CHECK( value.to_str() == "123456789012345678901234567890" );
+
+        auto [ptr2, ec2] = IntList::from_chars( ptr+1, s.data() + s.size(), value );
+        BOOST_CHECK( ec2 == std::errc() );
+        BOOST_CHECK( ptr2 == s.data() + s.size() );
+        BOOST_CHECK( value == IntList(42) );
+    }
+
+    {   //
+        // zeros, and nothing to parse at all
+        //
+        std::string_view zeros = "0000x";
+        auto [ptr, ec] = IntList::from_chars( zeros.data(), zeros.data() + zeros.size(), value );
+        BOOST_CHECK( ec == std::errc() && *ptr == 'x' );
+        BOOST_CHECK( value == IntList(0) );
+
+        IntList untouched( 99 );
+        std::string_view junk = "x123";
+        auto [ptr2, ec2] = IntList::from_chars( junk.data(), junk.data() + junk.size(), untouched );
+        BOOST_CHECK( ec2 == std::errc::invalid_argument && ptr2 == junk.data() );
+        BOOST_CHECK( untouched == IntList(99) );
+
+        auto [ptr3, ec3] = IntList::from_chars( junk.data(), junk.data(), untouched );
+        BOOST_CHECK( ec3 == std::errc::invalid_argument );
+    }
+
+    {   //
+        // a number off the front of a big buffer takes only its own digits'
+        // worth of room, however much buffer follows it
+        //
+        std::string buffer = "0012 " + std::string( 1 << 20, '7' );
+        auto [ptr, ec] = IntList::from_chars( buffer.data(), buffer.data() + buffer.size(), value );
+        BOOST_CHECK( ec == std::errc() && *ptr == ' ' );
+        BOOST_CHECK( value == IntList(12) );
+        BOOST_CHECK( digit_capacity( value ) == 2 );
+
+        std::string zeros = "000" + std::string( 1 << 20, 'x' );
+        auto [zeros_ptr, zeros_ec] = IntList::from_chars( zeros.data(), zeros.data() + zeros.size(), value );
+        BOOST_CHECK( zeros_ec == std::errc() && zeros_ptr == zeros.data() + 3 );
+        BOOST_CHECK( value == IntList(0) && digit_capacity( value ) == 1 );
+    }
+
+    {   //
+        // double-checking random values with c++ math
+        //
+        std::srand(time(nullptr));
+        for ( int i=0; i < 1000; i++ ) {
+            auto a = std::rand();
+            auto s = std::to_string(a);
+            IntList il( 0 );
+            IntList::from_chars( s.data(), s.data() + s.size(), il );
+            BOOST_CHECK( il.to_uint() == unsigned(a) );
+            BOOST_CHECK( IntList( s ).to_uint() == unsigned(a) );
+        }
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
 // *******************************************************************************
 // A string representation of the contents of integer list
 // *******************************************************************************
 //
 std::string IntList::to_str() const
 {
-    std::stringstream str;
-
-    for (auto i=il.begin(); i!=il.end(); ++i)
-        str << *i ;
+    std::string str( il.size(), '0' );
+    write_chars( str.data(), 0, il.size() );
+    return str;
+}
+//
+// (a plain loop over a contiguous range with no dependencies between digits,
+// which the compiler turns into vector narrowing adds)
+//
+void IntList::write_chars( char* out, unsigned long first, unsigned long count ) const
+{
+    if ( first > il.size() || count > il.size() - first )
+        throw std::out_of_range( "digits [" + std::to_string(first) + ", " + std::to_string(first+count) +
+                                 ") are not all in [0, " + std::to_string(il.size()) + ")" );
 
-    return str.str(); 
+    const value_type* digits = il.data() + first;
+    for ( unsigned long i = 0; i < count; ++i )
+        out[i] = char( '0' + digits[i] );
 }
 //
 // -------------------------------------------------------------------------------
@@ -1411,6 +2275,19 @@ BOOST_AUTO_TEST_CASE(intlist_to_str_tests)
     il_too_big.push_back(9); // should still be ok; string has arbitrary length 
     BOOST_CHECK_NO_THROW( auto val = il_too_big.to_str() );
 
+    {   //
+        // writing out part of the digits
+        //
+        IntList il {1,2,3,4,5,6,7,8,9};
+        std::string part( 4, ' ' );
+        il.write_chars( part.data(), 2, 4 );
+        BOOST_CHECK( part == "3456" );
+
+        BOOST_CHECK_NO_THROW( il.write_chars( part.data(), 9, 0 ) );
+        BOOST_CHECK_THROW( il.write_chars( part.data(), 6, 4 ), std::out_of_range );
+        BOOST_CHECK_THROW( il.write_chars( part.data(), 10, 0 ), std::out_of_range );
+    }
+
     {   //
         // double-checking random values with c++ math
         //
@@ -1498,6 +2375,11 @@ BOOST_AUTO_TEST_CASE(set_previous_index_0_data_address_function_tests)
 // *******************************************************************************
 //
 #if defined(BUILD_UNIT_TESTS)
+std::size_t digit_capacity(const IntList& il)
+{
+    return il.il.capacity();
+}
+//
 bool has_same_index_0_data_address_as_previous(IntList& il)
 {   //
     // Assuming a non-empty list, check the address of the first item in the IntList's internal
@@ -11,8 +11,17 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <filesystem>
 #include <compare>
 #include <ranges>
+#include <atomic>
+#include <functional>
+#include <concepts>
+#include <cstdint>
+
+class WorkStealingPool;
 
 class IntList
 //
@@ -30,6 +39,11 @@ private:
     using int_list_t = std::vector<value_type>;
     int_list_t il;
 
+    // hash() of the digits, or 0 if it hasn't been worked out since they last
+    // changed (atomic, so threads hashing a shared list don't race filling it)
+    mutable std::atomic<std::size_t> cached_hash {0};
+    void forget_hash() { cached_hash.store( 0, std::memory_order_relaxed ); }
+
     // msd utility functions
     static inline const value_type& msd (const int_list_t& il ) { return il.front(); }
     static inline void delete_msd (int_list_t& il ) { il.erase(il.begin()); }
@@ -44,11 +58,31 @@ private:
 
     void trim_leading_zeros( int_list_t& int_list ); 
 
+    void assign_wide( unsigned __int128 n );
+
+    // for the builders that made the digits themselves (so they're already
+    // 0-9, msd first and zero-trimmed): take the vector over without checking
+    // them all again
+    struct trusted_digits {};
+    IntList( std::vector<value_type>&& vec, trusted_digits );
+    friend class IntListAccumulator;
+    friend IntList add_parallel( const IntList& a, const IntList& b, WorkStealingPool& pool, unsigned long block_digits );
+    friend IntList subtract_parallel( const IntList& a, const IntList& b, WorkStealingPool& pool, unsigned long block_digits );
+
 public:
     // constructors
     IntList( std::initializer_list<value_type> il ); // init by initializer list
     IntList( std::vector<value_type>& vec );         // init by vector of digits 
+    IntList( std::vector<value_type>&& vec );        // init by vector of digits (taking it over)
     IntList( unsigned int ui );                      // init by unsigned int 
+    explicit IntList( std::string_view s );          // init by decimal string (msd first)
+
+    // init by a 64- or 128-bit unsigned value (anything narrower goes through
+    // unsigned int)
+    template<typename T>
+        requires ( (std::unsigned_integral<T> || std::same_as<T, unsigned __int128>) &&
+                   sizeof(T) > sizeof(unsigned int) )
+    IntList( T n ) { assign_wide( n ); }
 
     // copy & move semantics / construction
     IntList( const IntList& ) = delete; // no copy constructor!
@@ -64,11 +98,24 @@ public:
     // in lieu of copy constructor
     IntList clone() const; // "clone" from an existing integer list
 
-    // indexing operations
+    // indexing operations (the non-const [] drops the cached hash when it hands
+    // the reference out, not when it's written through: don't hold one across
+    // a hash(), or use set_digit())
     value_type& operator[]( int i );
     const value_type& operator[]( int i) const;
     void throw_on_invalid_index( int i, const int_list_t& il ) const;
 
+    // write one digit (range-checked, both index and value; a zero written
+    // over the msd is trimmed off), dropping the cached hash as it does
+    void set_digit( int i, value_type v );
+
+    // make this digits [first,last) of another list (leading zeros trimmed;
+    // an empty range is zero), reusing this list's storage rather than
+    // allocating: for scratch lists refilled over and over. reserve() sizes
+    // that storage up front.
+    void assign_digits( const IntList& from, unsigned long first, unsigned long last );
+    void reserve( unsigned long digits ) { il.reserve( digits ); }
+
     unsigned long size() const { return il.size(); }
 
     // available iterator types
@@ -77,24 +124,49 @@ public:
     using reverse_iterator = int_list_t::reverse_iterator;
     using const_reverse_iterator = int_list_t::const_reverse_iterator;
 
-    // iterator access
-    iterator begin() { return il.begin(); }
-    iterator end()   { return il.end  (); } 
+    // iterator access (the non-const ones can change digits, so they drop the
+    // cached hash; as with [], that happens when they're called, so writes
+    // through them have to be done before the next hash())
+    iterator begin() { forget_hash(); return il.begin(); }
+    iterator end()   { forget_hash(); return il.end  (); } 
 
     const_iterator cbegin() const { return il.cbegin(); }
     const_iterator cend()   const { return il.cend();   }
 
-    reverse_iterator rbegin() { return il.rbegin(); }
-    reverse_iterator rend()   { return il.rend();   }
+    reverse_iterator rbegin() { forget_hash(); return il.rbegin(); }
+    reverse_iterator rend()   { forget_hash(); return il.rend();   }
 
     const_reverse_iterator crbegin() const { return il.crbegin(); }
     const_reverse_iterator crend() const   { return il.crend();   }
 
+    // from_chars-style parsing: read the longest run of decimal digits at the
+    // front of [first,last) into value. ptr points just past the run; if there
+    // wasn't one, ec is std::errc::invalid_argument and value is left alone.
+    static std::from_chars_result from_chars( const char* first, const char* last, IntList& value );
+
+    // validate and convert decimal digits from [first,last) into out, up to
+    // the first non-digit; returns where it stopped
+    static const char* parse_digits( const char* first, const char* last, value_type* out );
+
     // generate string representation
     std::string to_str() const;
 
+    // write 'count' digits as ASCII, starting at msd-first index 'first', into
+    // out (which must have room for them); to_str() is this over all digits.
+    void write_chars( char* out, unsigned long first, unsigned long count ) const;
+
+    // read/write a decimal text file (msd first, like to_str) through a memory
+    // mapping; defined in IntListIO.cpp
+    static IntList load_mmap( const std::filesystem::path& path );
+    void save( const std::filesystem::path& path ) const;
+
     // generate uint representation (if small enough!)
     unsigned int to_uint() const;
+    std::uint64_t to_u64() const;
+
+    // hash of the value (equal lists hash equal); worked out once and kept
+    // until the digits next change
+    std::size_t hash() const;
 
     // c++20 autocomparison generation
     auto operator<=>(const IntList& that) const
@@ -111,7 +183,14 @@ public:
         else return this->il <=> that.il;
     }
 
-    bool operator==(const IntList&) const = default; // have to explicitly state this since we have custom <=> 
+    // have to explicitly state this since we have custom <=> (and not defaulted,
+    // since the cached hash isn't part of the value)
+    bool operator==(const IntList& that) const { return il == that.il; }
+
+    // (expressions evaluate_into() an IntList's own storage, and the operators
+    // on temporaries work in theirs)
+    template<typename Derived> friend class int_list_expr;
+    friend struct int_list_in_place;
 
 
 #if defined(BUILD_UNIT_TESTS)
@@ -123,6 +202,9 @@ public:
     // for testing clone v. move behaviors
     friend bool has_same_index_0_data_address_as_previous(IntList& il);
 
+    // for testing that parsing doesn't hold on to more room than it needs
+    friend std::size_t digit_capacity(const IntList& il);
+
     // for testing initialization helpers and validators
     friend void run_msd_tests();
     friend void run_lsd_tests();
@@ -133,8 +215,18 @@ public:
 #endif
 };
 
-IntList operator+(const IntList& a, const IntList& b);
-IntList operator-(const IntList& a, const IntList& b);
+// arithmetic operators (+, -, shifted, scalar *): on IntLists they return the
+// result right away (reusing a temporary left operand's storage, so a chain
+// builds one IntList); chains started with lazy() are fused into one pass
+// instead. See IntListExpr.h
+#include "IntListExpr.h"
+
+// so IntLists can key unordered containers
+template<>
+struct std::hash<IntList>
+{
+    std::size_t operator()( const IntList& il ) const noexcept { return il.hash(); }
+};
 
 #if defined(BUILD_UNIT_TESTS)
 void set_previous_index_0_data_address(IntList& il);
@@ -0,0 +1,200 @@
+//
+// IntListAccumulator.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// class definitions for a carry-save integer list accumulator (using RAII
+// patterns); sums any number of IntLists and only resolves carries once, when
+// the total is asked for.
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_INTLISTACCUMULATOR_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE IntListAccumulator Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_INTLISTACCUMULATOR_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+
+#include "IntListAccumulator.h"
+
+
+
+// ===============================================================================
+// class IntListAccumulator methods
+// ===============================================================================
+
+// *******************************************************************************
+// IntListAccumulator::add_shifted
+// *******************************************************************************
+//
+// Add il * 10^k into the lanes. No carries are propagated here; each lane just
+// soaks up the digit that lands on it.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void IntListAccumulator::add_shifted( const IntList& il, unsigned long k )
+{
+    if (pending_adds == max_pending_adds)
+        normalize();
+
+    if (lanes.size() < il.size() + k)
+        lanes.resize( il.size() + k, 0 );
+
+    auto lane = lanes.begin() + k;
+    for ( auto p = il.crbegin(); p != il.crend(); ++p )
+        *lane++ += *p;
+
+    ++pending_adds;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlistaccumulator_add_tests)
+{
+    {   //
+        // nothing added is zero
+        //
+        IntListAccumulator acc;
+        BOOST_CHECK( acc.finish() == IntList(0) );
+    }
+
+    {   //
+        // a handful of small values
+        //
+        IntListAccumulator acc;
+        acc.add( IntList(999) );
+        acc.add( IntList(1) );
+        acc.add( IntList(0) );
+        acc.add( IntList(123456) );
+        BOOST_CHECK( acc.finish() == IntList(124456) );
+    }
+
+    {   //
+        // lanes well past 9 before the single normalization
+        //
+        IntListAccumulator acc;
+        for ( int i=0; i < 10000; i++ )
+            acc.add( IntList(99999) );
+        BOOST_CHECK( acc.finish() == IntList(999990000) );
+    }
+
+    {   //
+        // shifted adds: 12*10^4 + 34*10^2 + 56
+        //
+        IntListAccumulator acc;
+        acc.add_shifted( IntList(12), 4 );
+        acc.add_shifted( IntList(34), 2 );
+        acc.add_shifted( IntList(56), 0 );
+        BOOST_CHECK( acc.finish() == IntList(123456) );
+    }
+
+    {   //
+        // double-checking random values against operator+
+        //
+        std::srand(time(nullptr));
+
+        IntListAccumulator acc;
+        IntList sum(0);
+        for ( int i=0; i < 1000; i++ ) {
+            IntList a( std::rand() );
+            unsigned long k = std::rand() % 20;
+
+            auto shifted = a.clone();
+            for ( unsigned long z=0; z < k; z++ )
+                shifted.push_back(0);
+
+            acc.add_shifted( a, k );
+            sum = sum + shifted;
+        }
+        BOOST_CHECK( acc.finish() == sum );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// IntListAccumulator::normalize
+// *******************************************************************************
+//
+// Ripple the carries through the lanes once so that every lane is back to a
+// single decimal digit (growing the lane list if the top lane carries out).
+//
+// *******************************************************************************
+//
+void IntListAccumulator::normalize()
+{
+    lane_type carry = 0;
+    for ( auto& lane : lanes ) {
+        lane += carry;
+        carry = lane/10;
+        lane %= 10;
+    }
+    for ( ; carry != 0; carry /= 10 )
+        lanes.push_back( carry%10 );
+
+    pending_adds = 0;
+}
+
+
+
+// *******************************************************************************
+// IntListAccumulator::finish
+// *******************************************************************************
+//
+// Normalize the lanes and hand back the total as an (msd-first, zero-trimmed)
+// IntList. The accumulator is left empty for reuse.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList IntListAccumulator::finish()
+{
+    normalize();
+
+    // drop the leading zeros here, rather than one at a time from the front of
+    // the IntList
+    while ( lanes.size() > 1 && lanes.back() == 0 )
+        lanes.pop_back();
+
+    std::vector<IntList::value_type> total( lanes.rbegin(), lanes.rend() );
+    if (total.empty())
+        total.push_back(0);
+
+    lanes.clear();
+    return IntList( std::move(total), IntList::trusted_digits{} );     // (normalized: all 0-9)
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlistaccumulator_finish_tests)
+{
+    IntListAccumulator acc;
+    acc.add( IntList(5) );
+    acc.add( IntList(5) );
+    BOOST_CHECK( acc.finish() == IntList(10) );
+
+    // ...and it starts over from zero afterwards
+    acc.add( IntList(7) );
+    BOOST_CHECK( acc.finish() == IntList(7) );
+    BOOST_CHECK( acc.finish() == IntList(0) );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
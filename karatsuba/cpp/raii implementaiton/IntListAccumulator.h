@@ -0,0 +1,62 @@
+//
+// IntListAccumulator.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class declaration for a carry-save integer list accumulator (using RAII
+// patterns); sums any number of IntLists and only resolves carries once, when
+// the total is asked for.
+//
+#ifndef __int_list_accumulator_h
+#define __int_list_accumulator_h
+
+#include <vector>
+
+#include "IntList.h"
+
+class IntListAccumulator
+//
+// A running sum of non-negative integer lists, held in redundant form (each
+// decimal position is a wide lane that is allowed to grow past 9)
+//
+{
+public:
+    // lane implementation type
+    using lane_type = unsigned long long;
+
+private:
+    // lanes are lsd-first (lanes[i] is the total at 10^i)
+    std::vector<lane_type> lanes;
+
+    // number of adds since the lanes were last normalized; once this reaches
+    // max_pending_adds another 9 per lane could overflow, so normalize first.
+    unsigned long long pending_adds = 0;
+    static const unsigned long long max_pending_adds = ~0ULL / IntList::upper_bound - 1;
+
+    void normalize();
+
+public:
+    // constructors
+    IntListAccumulator() = default;
+    explicit IntListAccumulator( unsigned long expected_digits ) { lanes.reserve( expected_digits ); }
+
+    // copy & move semantics / construction
+    IntListAccumulator( const IntListAccumulator& ) = delete;
+    IntListAccumulator( IntListAccumulator&& ) = default;
+    IntListAccumulator& operator=( const IntListAccumulator& ) = delete;
+    IntListAccumulator& operator=( IntListAccumulator&& ) = default;
+
+    // make room for a total of this many digits up front
+    void reserve( unsigned long expected_digits ) { lanes.reserve( expected_digits ); }
+    unsigned long capacity() const { return lanes.capacity(); }
+
+    // accumulate il, or il * 10^k
+    void add( const IntList& il ) { add_shifted( il, 0 ); }
+    void add_shifted( const IntList& il, unsigned long k );
+
+    // resolve all carries and return the total; leaves the accumulator empty
+    // (aka zero) and ready to be reused, with its lanes still allocated
+    IntList finish();
+};
+
+#endif // __int_list_accumulator_h
@@ -0,0 +1,477 @@
+//
+// IntListExpr.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// expression templates for integer list arithmetic; chains of +, -, decimal
+// shifts and scalar multiplies are captured as a tree of lightweight nodes and
+// evaluated in one fused lsd-to-msd pass when the expression is turned into an
+// IntList (ex: IntList s3 = lazy(s1xs2) - s1 - s2; never builds s1xs2 - s1).
+//
+// +, -, * and shifted() on plain IntLists still hand back an IntList (so
+// 'auto s = a + b;' is a value, same as ever), but one whose left operand is a
+// temporary works in that temporary's digits and hands it back: 'a + b + c'
+// and 's1xs2 - s1 - s2' build one IntList however long they are. A chain only
+// stays lazy (one pass rather than a pass per step) once one of its operands
+// is an expression, which starts with an explicit lazy().
+//
+#ifndef __int_list_expr_h
+#define __int_list_expr_h
+
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <concepts>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "IntList.h"
+
+// ===============================================================================
+// expression node plumbing
+// ===============================================================================
+
+// every expression node derives from this (so we can recognize them)
+struct int_list_expr_tag {};
+
+template<typename T>
+concept int_list_expression = std::derived_from<std::remove_cvref_t<T>, int_list_expr_tag>;
+
+// anything that can appear in an integer list expression
+template<typename T>
+concept int_list_operand = std::same_as<std::remove_cvref_t<T>, IntList> || int_list_expression<T>;
+
+// lvalue operands are held by reference (they outlive the full expression,
+// provided the expression is turned into an IntList before it ends);
+// temporaries are moved into the node so they can't dangle.
+template<typename T>
+using int_list_expr_storage_t = std::conditional_t< std::is_lvalue_reference_v<T>,
+                                                    const std::remove_reference_t<T>&,
+                                                    std::remove_cvref_t<T> >;
+
+// per-position signed digit contribution of an operand (lsd is position 0)
+inline long long int_list_expr_digit( const IntList& il, unsigned long pos )
+{
+    return pos < il.size() ? il.crbegin()[pos] : 0;
+}
+template<int_list_expression E>
+long long int_list_expr_digit( const E& e, unsigned long pos ) { return e.digit(pos); }
+
+// number of positions an operand can contribute to (before carries)
+inline unsigned long int_list_expr_extent( const IntList& il ) { return il.size(); }
+template<int_list_expression E>
+unsigned long int_list_expr_extent( const E& e ) { return e.extent(); }
+
+// the checked difference that operator-(IntList, IntList) has always thrown on
+inline void throw_on_negative_difference( const IntList& a, const IntList& b )
+{
+    if (!(a >= b)) {
+        std::stringstream error_msg_ss;
+        error_msg_ss << "a (" << a.to_str() << ") must be >= (" << b.to_str() << ")";
+        throw std::invalid_argument(error_msg_ss.str());
+    }
+}
+
+
+
+// *******************************************************************************
+// int_list_expr
+// *******************************************************************************
+//
+// CRTP base for all expression nodes; converts to an IntList (the fused pass)
+// wherever one is wanted. Nodes refer to their lvalue operands, so an
+// expression is only good until they change; assign it to an IntList rather
+// than keeping it around (never 'auto e = lazy(a) + b;').
+//
+// *******************************************************************************
+//
+template<typename Derived>
+class int_list_expr : public int_list_expr_tag
+{
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+    void evaluate_digits( std::vector<IntList::value_type>& digits ) const;
+
+public:
+    IntList evaluate() const;
+
+    // the same pass, into an existing IntList's storage (so scratch lists
+    // refilled over and over don't allocate each time). Unlike assignment, out
+    // can't be one of the operands; it's left zero if this throws.
+    void evaluate_into( IntList& out ) const;
+
+    operator IntList() const { return evaluate(); }
+
+    IntList     clone()   const { return evaluate(); }
+    std::string to_str()  const { return evaluate().to_str(); }
+    unsigned int to_uint() const { return evaluate().to_uint(); }
+};
+
+
+
+// *******************************************************************************
+// expression nodes
+// *******************************************************************************
+//
+class int_list_ref_expr : public int_list_expr< int_list_ref_expr >
+{
+    const IntList& il;
+public:
+    explicit int_list_ref_expr( const IntList& il ) : il(il) {}
+
+    long long digit( unsigned long pos ) const { return int_list_expr_digit(il,pos); }
+    unsigned long extent() const { return il.size(); }
+};
+//
+template<typename L, typename R>
+class int_list_sum_expr : public int_list_expr< int_list_sum_expr<L,R> >
+{
+    L l;
+    R r;
+public:
+    int_list_sum_expr( L&& l, R&& r ) : l(std::forward<L>(l)), r(std::forward<R>(r)) {}
+
+    long long digit( unsigned long pos ) const { return int_list_expr_digit(l,pos) + int_list_expr_digit(r,pos); }
+    unsigned long extent() const { return std::max( int_list_expr_extent(l), int_list_expr_extent(r) ); }
+};
+//
+template<typename L, typename R>
+class int_list_difference_expr : public int_list_expr< int_list_difference_expr<L,R> >
+{
+    L l;
+    R r;
+public:
+    int_list_difference_expr( L&& l, R&& r ) : l(std::forward<L>(l)), r(std::forward<R>(r)) {}
+
+    long long digit( unsigned long pos ) const { return int_list_expr_digit(l,pos) - int_list_expr_digit(r,pos); }
+    unsigned long extent() const { return std::max( int_list_expr_extent(l), int_list_expr_extent(r) ); }
+
+    // only reached when the whole expression came out negative; name the
+    // operands the same way the plain IntList subtraction does.
+    [[noreturn]] void throw_negative() const
+    {
+        const IntList& lv = l;
+        const IntList& rv = r;
+        throw_on_negative_difference( lv, rv );
+        throw std::logic_error("negative difference of non-negative operands");
+    }
+};
+//
+template<typename E>
+class int_list_shift_expr : public int_list_expr< int_list_shift_expr<E> >
+{
+    E e;
+    unsigned long k;
+public:
+    int_list_shift_expr( E&& e, unsigned long k ) : e(std::forward<E>(e)), k(k) {}
+
+    long long digit( unsigned long pos ) const { return pos < k ? 0 : int_list_expr_digit(e,pos-k); }
+    unsigned long extent() const { return int_list_expr_extent(e) + k; }
+};
+//
+template<typename E>
+class int_list_scale_expr : public int_list_expr< int_list_scale_expr<E> >
+{
+    E e;
+    unsigned int n;
+public:
+    int_list_scale_expr( E&& e, unsigned int n ) : e(std::forward<E>(e)), n(n) {}
+
+    long long digit( unsigned long pos ) const { return n * int_list_expr_digit(e,pos); }
+    unsigned long extent() const { return int_list_expr_extent(e); }
+};
+
+
+
+// *******************************************************************************
+// int_list_expr::evaluate
+// *******************************************************************************
+//
+// The fused pass: walk the positions lsd-first, let each node fold its
+// operands' digits into one signed column sum, and resolve carries/borrows
+// as we go. No intermediate IntList is ever built.
+//
+// NOTE that only the final value has to be non-negative; a subtraction deeper
+// in the expression may go "under water" on the way (a - b + c with b > a is
+// fine as long as the total isn't).
+//
+// *******************************************************************************
+//
+template<typename Derived>
+void int_list_expr<Derived>::evaluate_digits( std::vector<IntList::value_type>& digits ) const
+{
+    auto extent = self().extent();
+
+    digits.clear();     // (lsd first until the end)
+    digits.reserve( extent + 2 );
+
+    long long carry = 0;
+    for ( unsigned long pos = 0; pos < extent || carry > 0; ++pos ) {
+        long long column = self().digit(pos) + carry;
+        long long d = column % 10;
+        carry = column / 10;
+        if (d < 0) {
+            d += 10;
+            carry -= 1;
+        }
+        digits.push_back( d );
+    }
+
+    if (carry < 0) {
+        if constexpr ( requires { self().throw_negative(); } )
+            self().throw_negative();
+        throw std::invalid_argument("integer list expression must not be negative");
+    }
+
+    // trim the leading zeros here rather than one-at-a-time from the front
+    while ( digits.size() > 1 && digits.back() == 0 )
+        digits.pop_back();
+    if (digits.empty())
+        digits.push_back(0);
+
+    std::reverse( digits.begin(), digits.end() ); // msd should be at index-0
+}
+//
+template<typename Derived>
+IntList int_list_expr<Derived>::evaluate() const
+{
+    std::vector<IntList::value_type> digits;
+    evaluate_digits( digits );
+    return IntList( digits );
+}
+//
+template<typename Derived>
+void int_list_expr<Derived>::evaluate_into( IntList& out ) const
+{
+    out.forget_hash();
+    try {
+        evaluate_digits( out.il );
+    }
+    catch (...) {
+        out.il.assign( 1, 0 );
+        throw;
+    }
+}
+
+
+
+// *******************************************************************************
+// int_list_in_place
+// *******************************************************************************
+//
+// The same arithmetic done straight into an IntList's own digits, for the
+// operators whose left operand is a temporary nobody else will see again (the
+// rest of a chain). Each is one lsd-to-msd pass that stops once the shorter
+// operand and the carry run out; only a carry out of the msd moves anything.
+//
+// *******************************************************************************
+//
+struct int_list_in_place
+{
+    // il += that
+    static void add( IntList& il, const IntList& that )
+    {
+        auto& d = il.il;
+        il.forget_hash();
+        if ( d.size() < that.size() )
+            d.insert( d.begin(), that.size() - d.size(), 0 );
+
+        IntList::value_type carry = 0;
+        auto t = that.crbegin();
+        for ( auto i = d.rbegin(); i != d.rend() && (carry > 0 || t != that.crend()); ++i ) {
+            auto v = *i + carry + (t != that.crend() ? *t++ : 0);
+            carry = v > IntList::upper_bound;
+            *i = carry ? v - 10 : v;
+        }
+        if ( carry > 0 )
+            d.insert( d.begin(), carry );
+    }
+
+    // il -= that (throwing, like operator-, unless il >= that)
+    static void subtract( IntList& il, const IntList& that )
+    {
+        throw_on_negative_difference( il, that );
+
+        auto& d = il.il;
+        il.forget_hash();
+
+        int borrow = 0;
+        auto t = that.crbegin();
+        for ( auto i = d.rbegin(); i != d.rend() && (borrow > 0 || t != that.crend()); ++i ) {
+            int v = int(*i) - borrow - int( t != that.crend() ? *t++ : 0 );
+            borrow = v < 0;
+            *i = borrow ? v + 10 : v;
+        }
+        d.erase( d.begin(), std::find_if( d.begin(), d.end()-1, []( auto v ){ return v != 0; } ) );
+    }
+
+    // il *= 10^k
+    static void shift( IntList& il, unsigned long k )
+    {
+        auto& d = il.il;
+        if ( d.size() == 1 && d[0] == 0 )   // (zero stays zero)
+            return;
+        il.forget_hash();
+        d.insert( d.end(), k, 0 );
+    }
+
+    // il *= n
+    static void scale( IntList& il, unsigned int n )
+    {
+        auto& d = il.il;
+        il.forget_hash();
+        if ( n == 0 ) {
+            d.assign( 1, 0 );
+            return;
+        }
+
+        unsigned long long carry = 0;
+        for ( auto i = d.rbegin(); i != d.rend(); ++i ) {
+            auto v = (unsigned long long)( *i ) * n + carry;
+            *i = v % 10;
+            carry = v / 10;
+        }
+
+        IntList::value_type high[20];
+        std::size_t count = 0;
+        for ( ; carry > 0; carry /= 10 )
+            high[count++] = carry % 10;
+        d.insert( d.begin(), std::make_reverse_iterator( high + count ), std::make_reverse_iterator( high ) );
+    }
+};
+
+
+
+// ===============================================================================
+// operators
+// ===============================================================================
+
+// the start of a fused chain: 'IntList r = lazy(a) + b - c;' makes one pass
+inline int_list_ref_expr lazy( const IntList& il ) { return int_list_ref_expr( il ); }
+
+// plain IntList operands; evaluated right away, so the result is a value
+inline IntList operator+( const IntList& a, const IntList& b )
+{
+    return int_list_sum_expr< const IntList&, const IntList& >( a, b ).evaluate();
+}
+
+inline IntList operator-( const IntList& a, const IntList& b )
+{
+    throw_on_negative_difference( a, b );
+    return int_list_difference_expr< const IntList&, const IntList& >( a, b ).evaluate();
+}
+
+// multiply by 10^k
+inline IntList shifted( const IntList& il, unsigned long k )
+{
+    return int_list_shift_expr< const IntList& >( il, k ).evaluate();
+}
+
+// multiply by a (small) scalar
+inline IntList operator*( const IntList& il, unsigned int n )
+{
+    return int_list_scale_expr< const IntList& >( il, n ).evaluate();
+}
+inline IntList operator*( unsigned int n, const IntList& il )
+{
+    return int_list_scale_expr< const IntList& >( il, n ).evaluate();
+}
+
+// a temporary operand (the rest of a chain: the a + b in 'a + b + c') has the
+// result worked into its digits and is handed back, rather than another
+// IntList being built
+inline IntList operator+( IntList&& a, const IntList& b )
+{
+    int_list_in_place::add( a, b );
+    return std::move(a);
+}
+inline IntList operator+( const IntList& a, IntList&& b )
+{
+    int_list_in_place::add( b, a );
+    return std::move(b);
+}
+inline IntList operator+( IntList&& a, IntList&& b )
+{
+    int_list_in_place::add( a, b );
+    return std::move(a);
+}
+
+inline IntList operator-( IntList&& a, const IntList& b )
+{
+    int_list_in_place::subtract( a, b );
+    return std::move(a);
+}
+
+inline IntList shifted( IntList&& il, unsigned long k )
+{
+    int_list_in_place::shift( il, k );
+    return std::move(il);
+}
+
+inline IntList operator*( IntList&& il, unsigned int n )
+{
+    int_list_in_place::scale( il, n );
+    return std::move(il);
+}
+inline IntList operator*( unsigned int n, IntList&& il )
+{
+    int_list_in_place::scale( il, n );
+    return std::move(il);
+}
+
+// at least one operand is an expression; the result stays lazy
+template<int_list_operand L, int_list_operand R>
+    requires ( int_list_expression<L> || int_list_expression<R> )
+auto operator+( L&& a, R&& b )
+{
+    return int_list_sum_expr< int_list_expr_storage_t<L&&>, int_list_expr_storage_t<R&&> >(
+        std::forward<L>(a), std::forward<R>(b) );
+}
+
+template<int_list_operand L, int_list_operand R>
+    requires ( int_list_expression<L> || int_list_expression<R> )
+auto operator-( L&& a, R&& b )
+{
+    return int_list_difference_expr< int_list_expr_storage_t<L&&>, int_list_expr_storage_t<R&&> >(
+        std::forward<L>(a), std::forward<R>(b) );
+}
+
+template<int_list_expression E>
+auto shifted( E&& e, unsigned long k )
+{
+    return int_list_shift_expr< int_list_expr_storage_t<E&&> >( std::forward<E>(e), k );
+}
+
+template<int_list_expression E>
+auto operator*( E&& e, unsigned int n )
+{
+    return int_list_scale_expr< int_list_expr_storage_t<E&&> >( std::forward<E>(e), n );
+}
+template<int_list_expression E>
+auto operator*( unsigned int n, E&& e )
+{
+    return int_list_scale_expr< int_list_expr_storage_t<E&&> >( std::forward<E>(e), n );
+}
+// comparisons involving at least one unevaluated expression
+template<int_list_operand L, int_list_operand R>
+    requires ( int_list_expression<L> || int_list_expression<R> )
+std::strong_ordering operator<=>( const L& a, const R& b )
+{
+    const IntList& av = a;
+    const IntList& bv = b;
+    return av <=> bv;
+}
+template<int_list_operand L, int_list_operand R>
+    requires ( int_list_expression<L> || int_list_expression<R> )
+bool operator==( const L& a, const R& b )
+{
+    const IntList& av = a;
+    const IntList& bv = b;
+    return av == bv;
+}
+
+#endif // __int_list_expr_h
@@ -0,0 +1,655 @@
+//
+// IntListIO.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// class definitions for a memory-mapped file (using RAII patterns), and the
+// integer list file input/output built on it
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_INTLISTIO_UNIT_TEST_RUNNER IntList.cpp WorkStealingPool.cpp IntListParallel.cpp IntListIO.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_INTLISTIO_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE IntListIO Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_INTLISTIO_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "IntListIO.h"
+#include "IntListParallel.h"
+
+// the error for a failed system call on 'path', from errno
+static std::system_error system_error_for( const std::string& what, const std::filesystem::path& path )
+{
+    return std::system_error( errno, std::generic_category(), what + " " + path.string() );
+}
+
+
+
+// ===============================================================================
+// class MappedFile constructors
+// ===============================================================================
+
+// *******************************************************************************
+// MappedFile::MappedFile / MappedFile::~MappedFile
+// *******************************************************************************
+//
+// Open and map the whole file (an empty file has nothing to map, and just
+// comes out as an empty view). The reader tells the kernel it'll go through
+// the mapping front to back, so it can read ahead aggressively. A window has
+// to lie within the file as it is; asking for any of it past the end throws
+// std::out_of_range.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+MappedFile::MappedFile( const std::filesystem::path& path )
+{
+    fd = ::open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        throw system_error_for( "can't open", path );
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0 ) {
+        auto error = system_error_for( "can't stat", path );
+        release();
+        throw error;
+    }
+    length = st.st_size;
+
+    map( path, 0, PROT_READ, MAP_PRIVATE );
+    if ( base )
+        ::madvise( base, length, MADV_SEQUENTIAL );
+}
+//
+MappedFile::MappedFile( const std::filesystem::path& path, std::size_t size )
+{
+    fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+    if ( fd < 0 )
+        throw system_error_for( "can't create", path );
+
+    if ( ::ftruncate( fd, size ) != 0 ) {
+        auto error = system_error_for( "can't resize", path );
+        release();
+        throw error;
+    }
+    length = size;
+
+    map( path, 0, PROT_READ | PROT_WRITE, MAP_SHARED );
+}
+//
+MappedFile::MappedFile( const std::filesystem::path& path, std::size_t offset, std::size_t size, access how )
+{
+    fd = ::open( path.c_str(), how == access::read ? O_RDONLY : O_RDWR );
+    if ( fd < 0 )
+        throw system_error_for( "can't open", path );
+
+    // (a window past the end would map, but touching it is a SIGBUS)
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0 ) {
+        auto error = system_error_for( "can't stat", path );
+        release();
+        throw error;
+    }
+    const std::size_t file_size = st.st_size;
+    if ( offset > file_size || size > file_size - offset ) {
+        release();
+        throw std::out_of_range( "bytes [" + std::to_string(offset) + ", " + std::to_string(offset) + "+" +
+                                 std::to_string(size) + ") are past the end of " + path.string() +
+                                 " (" + std::to_string(file_size) + " bytes)" );
+    }
+
+    length = size;
+    if ( how == access::read )
+        map( path, offset, PROT_READ, MAP_PRIVATE );
+    else
+        map( path, offset, PROT_READ | PROT_WRITE, MAP_SHARED );
+}
+//
+MappedFile::~MappedFile()
+{
+    release();
+}
+//
+MappedFile::MappedFile( MappedFile&& that )
+    : fd( std::exchange( that.fd, -1 ) ),
+      base( std::exchange( that.base, nullptr ) ),
+      slack( std::exchange( that.slack, 0 ) ),
+      length( std::exchange( that.length, 0 ) )
+{
+}
+//
+MappedFile& MappedFile::operator=( MappedFile&& that )
+{
+    if ( this != &that ) {
+        release();
+        fd     = std::exchange( that.fd, -1 );
+        base   = std::exchange( that.base, nullptr );
+        slack  = std::exchange( that.slack, 0 );
+        length = std::exchange( that.length, 0 );
+    }
+    return *this;
+}
+//
+// map 'length' bytes from 'offset' (mappings have to start on a page, so back
+// up to the one the offset is on and remember how far that was)
+//
+void MappedFile::map( const std::filesystem::path& path, std::size_t offset, int prot, int flags )
+{
+    if ( length == 0 )
+        return;
+
+    static const std::size_t page = ::sysconf( _SC_PAGESIZE );
+    slack = offset % page;
+
+    void* p = ::mmap( nullptr, slack + length, prot, flags, fd, offset - slack );
+    if ( p == MAP_FAILED ) {
+        auto error = system_error_for( "can't map", path );
+        release();
+        throw error;
+    }
+    base = static_cast<char*>( p );
+}
+//
+void MappedFile::release()
+{
+    if ( base )
+        ::munmap( base, slack + length );
+    if ( fd >= 0 )
+        ::close( fd );
+
+    fd = -1;
+    base = nullptr;
+    slack = 0;
+    length = 0;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+
+// a file name in the temp directory that nobody else is using (and that gets
+// cleaned up afterwards)
+struct temp_file_path
+{
+    std::filesystem::path path;
+
+    temp_file_path()
+        : path( std::filesystem::temp_directory_path() /
+                ("intlistio_test_" + std::to_string(::getpid()) + "_" + std::to_string(counter++)) )
+    {}
+    ~temp_file_path() { std::filesystem::remove( path ); }
+
+    static inline int counter = 0;
+};
+
+BOOST_AUTO_TEST_CASE(mappedfile_tests)
+{
+    temp_file_path tmp;
+
+    {   //
+        // write through one mapping, read back through another
+        //
+        {
+            MappedFile out( tmp.path, 5 );
+            BOOST_CHECK( out.size() == 5 );
+            std::copy_n( "hello", 5, out.data() );
+        }
+        BOOST_CHECK( std::filesystem::file_size( tmp.path ) == 5 );
+
+        MappedFile in( tmp.path );
+        BOOST_CHECK( in.view() == "hello" );
+
+        // moving hands the mapping over
+        MappedFile moved( std::move(in) );
+        BOOST_CHECK( moved.view() == "hello" );
+        BOOST_CHECK( in.size() == 0 );
+    }
+
+    {   //
+        // empty files, and files that aren't there
+        //
+        { MappedFile out( tmp.path, 0 ); }
+        BOOST_CHECK( MappedFile( tmp.path ).view().empty() );
+
+        BOOST_CHECK_THROW( MappedFile( tmp.path / "nope" ), std::system_error );
+    }
+
+    {   //
+        // windows that don't start on a page boundary
+        //
+        const std::size_t size = 3*4096 + 100;
+        {
+            MappedFile out( tmp.path, size );
+            for ( std::size_t i=0; i < size; i++ )
+                out.data()[i] = char( 'a' + i % 26 );
+        }
+
+        MappedFile in( tmp.path, 5000, 30, MappedFile::access::read );
+        BOOST_CHECK( in.size() == 30 );
+        BOOST_CHECK( in.data()[0] == char( 'a' + 5000 % 26 ) );
+        BOOST_CHECK( in.data()[29] == char( 'a' + 5029 % 26 ) );
+
+        {
+            MappedFile patch( tmp.path, 4095, 2, MappedFile::access::write );
+            patch.data()[0] = '<';
+            patch.data()[1] = '>';
+        }
+        BOOST_CHECK( MappedFile( tmp.path ).view().substr( 4094, 4 ) ==
+                     std::string() + char( 'a' + 4094 % 26 ) + "<>" + char( 'a' + 4097 % 26 ) );
+    }
+
+    {   //
+        // windows that run past the end of the file are refused (rather than
+        // mapped, to fault on first touch), however big the numbers
+        //
+        const std::size_t size = 3*4096 + 100;
+        { MappedFile out( tmp.path, size ); }
+
+        BOOST_CHECK( MappedFile( tmp.path, size - 10, 10, MappedFile::access::read ).size() == 10 );
+        BOOST_CHECK( MappedFile( tmp.path, size, 0, MappedFile::access::read ).size() == 0 );
+
+        for ( auto how : { MappedFile::access::read, MappedFile::access::write } ) {
+            BOOST_CHECK_THROW( MappedFile( tmp.path, size - 10, 11, how ), std::out_of_range );
+            BOOST_CHECK_THROW( MappedFile( tmp.path, size + 1, 0, how ), std::out_of_range );
+            BOOST_CHECK_THROW( MappedFile( tmp.path, 5*4096, 1, how ), std::out_of_range );
+            BOOST_CHECK_THROW( MappedFile( tmp.path, 1, SIZE_MAX, how ), std::out_of_range );
+            BOOST_CHECK_THROW( MappedFile( tmp.path, SIZE_MAX, 2, how ), std::out_of_range );
+        }
+        BOOST_CHECK( std::filesystem::file_size( tmp.path ) == size );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class IntList file input/output
+// ===============================================================================
+
+// *******************************************************************************
+// IntList::load_mmap / IntList::save
+// *******************************************************************************
+//
+// Digits go straight between the mapping and the IntList, in parallel blocks
+// for big values; there's never a std::string copy of the whole number.
+//
+// The file holds exactly what to_str() returns (msd first, no leading zeros)
+// and nothing else. A trailing newline, as most editors and tools leave, is
+// ignored on the way in; any other non-digit is an error, like it would be for
+// the string constructor.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList IntList::load_mmap( const std::filesystem::path& path )
+{
+    MappedFile file( path );
+
+    auto text = file.view();
+    while ( !text.empty() && (text.back() == '\n' || text.back() == '\r') )
+        text.remove_suffix( 1 );
+
+    return from_str_parallel( text );
+}
+//
+void IntList::save( const std::filesystem::path& path ) const
+{
+    MappedFile file( path, il.size() );
+    write_chars_parallel( *this, file.data() );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_load_save_tests)
+{
+    temp_file_path tmp;
+
+    {   //
+        // round trips, big and small
+        //
+        std::srand(time(nullptr));
+
+        for ( unsigned long digits : { 1UL, 7UL, 1000UL, 3UL << 20 } ) {
+            std::vector<IntList::value_type> v( digits );
+            for ( auto& d : v )
+                d = std::rand() % 10;
+            v[0] = 1 + std::rand() % 9;
+            IntList x( v );
+
+            x.save( tmp.path );
+            BOOST_CHECK( std::filesystem::file_size( tmp.path ) == digits );
+            BOOST_CHECK( IntList::load_mmap( tmp.path ) == x );
+        }
+
+        IntList zero( 0 );
+        zero.save( tmp.path );
+        BOOST_CHECK( IntList::load_mmap( tmp.path ) == zero );
+    }
+
+    {   //
+        // files written by something else
+        //
+        { std::ofstream( tmp.path ) << "000123456789\n"; }
+        BOOST_CHECK( IntList::load_mmap( tmp.path ) == IntList( 123456789 ) );
+
+        { std::ofstream( tmp.path ) << "123 456\n"; }
+        BOOST_CHECK_THROW( IntList::load_mmap( tmp.path ), std::invalid_argument );
+
+        { std::ofstream( tmp.path ) << "\n"; }
+        BOOST_CHECK_THROW( IntList::load_mmap( tmp.path ), std::invalid_argument );
+
+        BOOST_CHECK_THROW( IntList::load_mmap( tmp.path / "nope" ), std::system_error );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+
+// ===============================================================================
+// binary integer list format
+// ===============================================================================
+
+// little-endian field access, whatever the host byte order
+template<typename T>
+static void store_le( char* p, T v )
+{
+    for ( std::size_t i = 0; i < sizeof(T); ++i, v >>= 8 )
+        p[i] = char( v & 0xFF );
+}
+template<typename T>
+static T load_le( const char* p )
+{
+    T v = 0;
+    for ( std::size_t i = sizeof(T); i-- > 0; )
+        v = (v << 8) | T( static_cast<unsigned char>(p[i]) );
+    return v;
+}
+
+static const char int_list_magic[8] = { 'I','N','T','L','I','S','T','\0' };
+
+
+
+// *******************************************************************************
+// int_list_checksum
+// *******************************************************************************
+//
+// Four independent multiply-rotate lanes over 8-byte words (so the multiplies
+// overlap instead of waiting on each other), folded together at the end with
+// the tail bytes and the length. Runs at several GB/s, well past what the disk
+// can feed it.
+//
+// *******************************************************************************
+//
+std::uint64_t int_list_checksum( std::span<const char> bytes )
+{
+    constexpr std::uint64_t k1 = 0x9E3779B97F4A7C15ULL;
+    constexpr std::uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+
+    std::uint64_t lanes[4] = { k1, k2, k1 ^ k2, ~k1 };
+
+    auto mix = []( std::uint64_t h, std::uint64_t w ) {
+        return std::rotl( (h ^ w) * k2, 31 ) * k1;
+    };
+
+    const char* p = bytes.data();
+    std::size_t n = bytes.size();
+
+    for ( ; n >= 32; p += 32, n -= 32 )
+        for ( int l = 0; l < 4; ++l )
+            lanes[l] = mix( lanes[l], load_le<std::uint64_t>( p + 8*l ) );
+
+    std::uint64_t h = bytes.size() * k1;
+    for ( auto lane : lanes )
+        h = mix( h, lane );
+
+    for ( ; n >= 8; p += 8, n -= 8 )
+        h = mix( h, load_le<std::uint64_t>( p ) );
+    if ( n > 0 ) {
+        char tail[8] = {};
+        std::memcpy( tail, p, n );
+        h = mix( h, load_le<std::uint64_t>( tail ) );
+    }
+
+    // final avalanche so nearby inputs don't give nearby checksums
+    h ^= h >> 33; h *= k2;
+    h ^= h >> 29; h *= k1;
+    h ^= h >> 32;
+    return h;
+}
+
+
+
+// *******************************************************************************
+// serialized_size / serialize / deserialize
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::size_t serialized_size( const IntList& il )
+{
+    return int_list_header_size + (il.size() + 1) / 2;
+}
+//
+std::size_t serialize( const IntList& il, std::span<char> out )
+{
+    const std::size_t size = serialized_size( il );
+    if ( out.size() < size )
+        throw std::invalid_argument( "out (" + std::to_string(out.size()) + " bytes) must be >= (" +
+                                     std::to_string(size) + " bytes)" );
+
+    //
+    // payload first, so the header can carry its checksum
+    //
+    const std::size_t n = il.size();
+    char* payload = out.data() + int_list_header_size;
+    auto d = il.cbegin();
+
+    for ( std::size_t i = 0; i < n/2; ++i, d += 2 )
+        payload[i] = char( (d[0] << 4) | d[1] );
+    if ( n % 2 )
+        payload[n/2] = char( d[0] << 4 );
+
+    char* header = out.data();
+    std::memcpy( header, int_list_magic, sizeof(int_list_magic) );
+    store_le<std::uint16_t>( header +  8, int_list_format_version );
+    store_le<std::uint16_t>( header + 10, std::uint16_t( int_list_payload::packed_bcd ) );
+    store_le<std::uint32_t>( header + 12, 0 );
+    store_le<std::uint64_t>( header + 16, n );
+    store_le<std::uint64_t>( header + 24, int_list_checksum( { payload, size - int_list_header_size } ) );
+
+    return size;
+}
+//
+IntList deserialize( std::span<const char> in )
+{
+    if ( in.size() < int_list_header_size || std::memcmp( in.data(), int_list_magic, sizeof(int_list_magic) ) != 0 )
+        throw std::invalid_argument( "not a serialized integer list" );
+
+    const char* header = in.data();
+    auto version        = load_le<std::uint16_t>( header +  8 );
+    auto representation = load_le<std::uint16_t>( header + 10 );
+    auto n              = load_le<std::uint64_t>( header + 16 );
+    auto checksum       = load_le<std::uint64_t>( header + 24 );
+
+    if ( version != int_list_format_version )
+        throw std::invalid_argument( "unsupported integer list format version " + std::to_string(version) );
+    if ( representation != std::uint16_t( int_list_payload::packed_bcd ) )
+        throw std::invalid_argument( "unsupported integer list representation " + std::to_string(representation) );
+
+    //
+    // check the digit count against what the buffer could hold before doing
+    // any arithmetic on it (a corrupt or hostile count near UINT64_MAX would
+    // wrap (n + 1) / 2, and then ask for an impossible vector)
+    //
+    if ( n == 0 || n > (in.size() - int_list_header_size) * 2 )
+        throw std::invalid_argument( "serialized integer list is truncated" );
+    const std::size_t payload_size = (n + 1) / 2;
+
+    auto payload = in.subspan( int_list_header_size, payload_size );
+    if ( int_list_checksum( payload ) != checksum )
+        throw std::invalid_argument( "serialized integer list failed its checksum" );
+
+    //
+    // unpack straight out of the buffer; any nibble over 9 means the data was
+    // corrupt in a way the checksum happened to miss (or was written that way)
+    //
+    std::vector<IntList::value_type> digits( n );
+    unsigned int bad = 0;
+
+    for ( std::size_t i = 0; i < n/2; ++i ) {
+        unsigned int b = static_cast<unsigned char>( payload[i] );
+        digits[2*i]   = b >> 4;
+        digits[2*i+1] = b & 0x0F;
+        bad |= (digits[2*i] > 9) | (digits[2*i+1] > 9);
+    }
+    if ( n % 2 ) {
+        digits[n-1] = static_cast<unsigned char>( payload[n/2] ) >> 4;
+        bad |= digits[n-1] > 9;
+    }
+
+    if ( bad )
+        throw std::invalid_argument( "serialized integer list has a digit out of range" );
+
+    return IntList( std::move(digits) );
+}
+//
+void save_binary( const IntList& il, const std::filesystem::path& path )
+{
+    MappedFile file( path, serialized_size( il ) );
+    serialize( il, { file.data(), file.size() } );
+}
+//
+IntList load_binary( const std::filesystem::path& path )
+{
+    MappedFile file( path );
+    return deserialize( { file.data(), file.size() } );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlist_serialization_tests)
+{
+    {   //
+        // round trips through memory, odd and even lengths
+        //
+        for ( unsigned long digits : { 1UL, 2UL, 3UL, 1000UL, 100001UL } ) {
+            std::vector<IntList::value_type> v( digits );
+            for ( auto& d : v )
+                d = std::rand() % 10;
+            v[0] = 1 + std::rand() % 9;
+            IntList x( v );
+
+            std::vector<char> buffer( serialized_size( x ) );
+            BOOST_CHECK( serialize( x, buffer ) == buffer.size() );
+            BOOST_CHECK( buffer.size() == 32 + (digits+1)/2 );
+            BOOST_CHECK( deserialize( buffer ) == x );
+        }
+    }
+
+    {   //
+        // the layout itself: 12345 packs to 12 34 50
+        //
+        IntList x( 12345 );
+        std::vector<char> buffer( serialized_size( x ) );
+        serialize( x, buffer );
+
+        BOOST_CHECK( std::string_view( buffer.data(), 7 ) == "INTLIST" );
+        BOOST_CHECK( buffer[8] == 1 && buffer[9] == 0 );
+        BOOST_CHECK( buffer[16] == 5 );
+        BOOST_CHECK( buffer[32] == 0x12 && buffer[33] == 0x34 && buffer[34] == 0x50 );
+    }
+
+    {   //
+        // damaged, foreign, and short buffers are all rejected
+        //
+        IntList x( 987654321 );
+        std::vector<char> good( serialized_size( x ) );
+        serialize( x, good );
+
+        auto flipped = good;       flipped[33] ^= 0x01;
+        auto magic = good;         magic[0] = 'X';
+        auto version = good;       version[8] = 2;
+        auto short_one = good;     short_one.pop_back();
+        auto bad_nibble = good;    bad_nibble[32] = char(0xA1);
+        store_le<std::uint64_t>( bad_nibble.data() + 24,
+                                 int_list_checksum( { bad_nibble.data() + 32, bad_nibble.size() - 32 } ) );
+
+        BOOST_CHECK_THROW( deserialize( flipped ), std::invalid_argument );
+        BOOST_CHECK_THROW( deserialize( magic ), std::invalid_argument );
+        BOOST_CHECK_THROW( deserialize( version ), std::invalid_argument );
+        BOOST_CHECK_THROW( deserialize( short_one ), std::invalid_argument );
+        BOOST_CHECK_THROW( deserialize( bad_nibble ), std::invalid_argument );
+        BOOST_CHECK_THROW( deserialize( std::span<const char>() ), std::invalid_argument );
+
+        // digit counts the buffer couldn't possibly hold, including ones that
+        // would overflow the payload size
+        for ( std::uint64_t n : { std::uint64_t(19), std::uint64_t(1) << 62, UINT64_MAX - 1, UINT64_MAX } ) {
+            auto huge = good;
+            store_le<std::uint64_t>( huge.data() + 16, n );
+            BOOST_CHECK_THROW( deserialize( huge ), std::invalid_argument );
+        }
+        auto wrapped = good;    // (n + 1) / 2 == 0, with a checksum to match
+        store_le<std::uint64_t>( wrapped.data() + 16, UINT64_MAX );
+        store_le<std::uint64_t>( wrapped.data() + 24, int_list_checksum( {} ) );
+        BOOST_CHECK_THROW( deserialize( wrapped ), std::invalid_argument );
+
+        std::vector<char> too_small( 10 );
+        BOOST_CHECK_THROW( serialize( x, too_small ), std::invalid_argument );
+    }
+
+    {   //
+        // and through a mapped file
+        //
+        temp_file_path tmp;
+        std::vector<IntList::value_type> v( 1UL << 20, 7 );
+        IntList x( v );
+
+        save_binary( x, tmp.path );
+        BOOST_CHECK( std::filesystem::file_size( tmp.path ) == 32 + (1UL << 19) );
+        BOOST_CHECK( load_binary( tmp.path ) == x );
+
+        x.save( tmp.path );    // (text, not binary)
+        BOOST_CHECK_THROW( load_binary( tmp.path ), std::invalid_argument );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+//
+// IntListIO.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class declaration for a memory-mapped file (using RAII patterns), used to read
+// and write integer lists without staging them in intermediate strings.
+//
+#ifndef __int_list_io_h
+#define __int_list_io_h
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "IntList.h"
+
+class MappedFile
+//
+// A file (or a window of one) mapped into memory; unmapped and closed when it
+// goes away
+//
+{
+    int fd = -1;
+    char* base = nullptr;       // start of the mapping (page-aligned)
+    std::size_t slack = 0;      // bytes from base to the first one asked for
+    std::size_t length = 0;     // bytes asked for
+
+    void map( const std::filesystem::path& path, std::size_t offset, int prot, int flags );
+    void release();
+
+public:
+    enum class access { read, write };
+
+    // constructors
+    explicit MappedFile( const std::filesystem::path& path );     // map an existing file, read-only
+    MappedFile( const std::filesystem::path& path, std::size_t size ); // create (or truncate) a file of
+                                                                   // 'size' bytes, mapped read-write
+    MappedFile( const std::filesystem::path& path,                // map just bytes [offset, offset+size)
+                std::size_t offset, std::size_t size, access how ); // of an existing file (std::out_of_range
+                                                                   // if the file is shorter)
+    ~MappedFile();
+
+    // copy & move semantics / construction
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile( MappedFile&& that );
+    MappedFile& operator=( const MappedFile& ) = delete;
+    MappedFile& operator=( MappedFile&& that );
+
+    std::size_t size() const { return length; }
+
+    // mapped bytes (only write through a file mapped read-write!)
+    const char* data() const { return base + slack; }
+    char* data() { return base + slack; }
+    std::string_view view() const { return { data(), length }; }
+};
+
+
+
+
+// ===============================================================================
+// binary integer list format
+// ===============================================================================
+//
+// A fixed 32-byte header (all fields little-endian) followed by the payload:
+//
+//     offset  size  field
+//          0     8  magic, "INTLIST" and a NUL
+//          8     2  format version (int_list_format_version)
+//         10     2  payload representation (int_list_payload::packed_bcd)
+//         12     4  reserved, 0
+//         16     8  number of decimal digits
+//         24     8  checksum of the payload (int_list_checksum)
+//         32     -  payload
+//
+// packed_bcd holds two digits per byte, msd first, high nibble first; an odd
+// digit count leaves the last low nibble 0.
+//
+const std::uint16_t int_list_format_version = 1;
+enum class int_list_payload : std::uint16_t { packed_bcd = 1 };
+const std::size_t int_list_header_size = 32;
+
+// bytes serialize() needs for il
+std::size_t serialized_size( const IntList& il );
+
+// write il into out (which must hold at least serialized_size(il) bytes), and
+// return the number of bytes written
+std::size_t serialize( const IntList& il, std::span<char> out );
+
+// read an IntList back out of a serialized buffer (a mapped file, say);
+// throws std::invalid_argument if it isn't one, is truncated, or is corrupt
+IntList deserialize( std::span<const char> in );
+
+// the same, to and from a file
+void save_binary( const IntList& il, const std::filesystem::path& path );
+IntList load_binary( const std::filesystem::path& path );
+
+// 64-bit checksum used by the format (not cryptographic; catches corruption)
+std::uint64_t int_list_checksum( std::span<const char> bytes );
+
+#endif // __int_list_io_h
@@ -0,0 +1,432 @@
+//
+// IntListParallel.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// multi-threaded versions of the integer list operations that are otherwise a
+// single sequential pass over the digits
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_INTLISTPARALLEL_UNIT_TEST_RUNNER IntList.cpp WorkStealingPool.cpp IntListParallel.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_INTLISTPARALLEL_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE IntListParallel Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_INTLISTPARALLEL_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "IntListParallel.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// run f(0) ... f(count-1) as pool tasks and wait for all of them (all of
+// them, even if one throws or a fork fails, since they refer to f and the
+// caller's locals; then the first exception goes on)
+template<typename F>
+static void for_each_block( WorkStealingPool& pool, unsigned long count, F f )
+{
+    std::vector<WorkStealingPool::task_handle<void>> tasks;
+    std::exception_ptr error;
+    try {
+        tasks.reserve( count );
+        for ( unsigned long k = 0; k < count; ++k )
+            tasks.push_back( pool.fork( [&f, k]{ f(k); } ) );
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    for ( auto& t : tasks )
+        try { pool.join( t ); }
+        catch (...) { if (!error) error = std::current_exception(); }
+
+    if ( error )
+        std::rethrow_exception( error );
+}
+
+
+
+// *******************************************************************************
+// add_parallel / subtract_parallel
+// *******************************************************************************
+//
+// Carry-select addition over blocks of 'block_digits' digits:
+//
+//  1. every block is summed on its own (in parallel) as if no carry came in,
+//     and reports whether it *generates* a carry out regardless, and whether
+//     it would *propagate* one that came in (all of its digits came out 9s);
+//  2. the carry into each block follows from the flags of the blocks below it,
+//        carry_in[k+1] = generate[k] | (propagate[k] & carry_in[k])
+//     (a prefix scan over one flag pair per block);
+//  3. every block that does get a carry in adds it at its lsd (in parallel),
+//     which ripples no further than its own first non-9 digit.
+//
+// Subtraction is the same with borrows: a block propagates a borrow when all
+// of its digits came out 0s, and fixing it up ripples through 0s instead.
+//
+// NOTE that the scan in step 2 is done sequentially; it's one step per block
+// (a few hundred for 10^7 digits) and the combine is a couple of ands and ors,
+// so it never shows up next to the two digit passes around it.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+enum class carry_op { add, subtract };
+
+// (a and b have at least two blocks' worth of digits between them; the digits
+// come back msd-first and zero-trimmed, ready for an IntList to take over)
+template<carry_op Op>
+static std::vector<IntList::value_type> carry_parallel( const IntList& a, const IntList& b, WorkStealingPool& pool,
+                                                        unsigned long block_digits )
+{
+    using value_type = IntList::value_type;
+
+    if constexpr ( Op == carry_op::subtract )
+        throw_on_negative_difference( a, b );
+
+    const unsigned long n = std::max( a.size(), b.size() );
+    auto digit_of = []( const IntList& il, unsigned long pos ) -> int {
+        return pos < il.size() ? int( il.crbegin()[pos] ) : 0;
+    };
+
+    //
+    // an add carries out of the top exactly when the column sums, from the msd
+    // down, reach 10 before they drop below 9 (the first column almost always
+    // settles it), so the result can be sized for that up front rather than
+    // shifted down after
+    //
+    unsigned long top = 0;
+    if constexpr ( Op == carry_op::add )
+        for ( auto pos = n; pos-- > 0; ) {
+            int sum = digit_of(a,pos) + digit_of(b,pos);
+            if ( sum != 9 ) {
+                top = sum >= 10;
+                break;
+            }
+        }
+
+    // result is msd-first like everything else; the digit at 10^pos lives at
+    // result[last - pos]
+    std::vector<value_type> result( n + top );
+    const unsigned long last = n + top - 1;
+
+    const unsigned long blocks = (n + block_digits - 1) / block_digits;
+    struct carry_flags { bool generate = false, propagate = false; };
+    std::vector<carry_flags> flags( blocks );
+
+    // 1. independent block sums
+    for_each_block( pool, blocks, [&]( unsigned long k ) {
+        const unsigned long lo = k*block_digits;
+        const unsigned long hi = std::min( n, lo + block_digits );
+
+        int carry = 0;
+        bool saturated = true;                  // all 9s (add) or all 0s (subtract)
+        for ( auto pos = lo; pos < hi; ++pos ) {
+            int d;
+            if constexpr ( Op == carry_op::add ) {
+                d = digit_of(a,pos) + digit_of(b,pos) + carry;
+                carry = d >= 10;
+                d -= carry ? 10 : 0;
+                saturated &= d == 9;
+            }
+            else {
+                d = digit_of(a,pos) - digit_of(b,pos) - carry;
+                carry = d < 0;
+                d += carry ? 10 : 0;
+                saturated &= d == 0;
+            }
+            result[last - pos] = d;
+        }
+        flags[k] = { carry != 0, saturated };
+    } );
+
+    // 2. carries into each block
+    std::vector<char> carry_in( blocks+1, false );
+    for ( unsigned long k = 0; k < blocks; ++k )
+        carry_in[k+1] = flags[k].generate || (flags[k].propagate && carry_in[k]);
+
+    // 3. fix up the blocks that got one
+    for_each_block( pool, blocks, [&]( unsigned long k ) {
+        if ( !carry_in[k] )
+            return;
+
+        const unsigned long lo = k*block_digits;
+        const unsigned long hi = std::min( n, lo + block_digits );
+
+        for ( auto pos = lo; pos < hi; ++pos ) {
+            auto& d = result[last - pos];
+            if constexpr ( Op == carry_op::add ) {
+                if ( d != 9 ) { ++d; break; }
+                d = 0;
+            }
+            else {
+                if ( d != 0 ) { --d; break; }
+                d = 9;
+            }
+        }
+    } );
+
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( bool( carry_in[blocks] ) == bool( top ) );  // (subtraction: a >= b, so never)
+#endif
+    if ( top )
+        result[0] = 1;
+
+    // only a difference can have leading zeros (a sum's top digit is the
+    // carry, or the longer operand's msd plus something that didn't carry)
+    if constexpr ( Op == carry_op::subtract ) {
+        auto first = std::find_if( result.begin(), result.end()-1, []( value_type d ) { return d != 0; } );
+        result.erase( result.begin(), first );
+    }
+
+    return result;
+}
+//
+// whether a and b are long enough to be worth cutting into blocks at all
+static bool worth_splitting( const IntList& a, const IntList& b, unsigned long block_digits )
+{
+    if ( block_digits == 0 )
+        throw std::invalid_argument( "block_digits must be > 0" );
+    return std::max( a.size(), b.size() ) >= block_digits*2;
+}
+//
+IntList add_parallel( const IntList& a, const IntList& b, WorkStealingPool& pool, unsigned long block_digits )
+{
+    if ( !worth_splitting( a, b, block_digits ) )
+        return a + b;
+    return IntList( carry_parallel<carry_op::add>( a, b, pool, block_digits ), IntList::trusted_digits{} );
+}
+//
+IntList subtract_parallel( const IntList& a, const IntList& b, WorkStealingPool& pool, unsigned long block_digits )
+{
+    if ( !worth_splitting( a, b, block_digits ) )
+        return a - b;
+    return IntList( carry_parallel<carry_op::subtract>( a, b, pool, block_digits ), IntList::trusted_digits{} );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+
+// 'digits' copies of d
+static IntList repeated_digit( unsigned long digits, unsigned int d )
+{
+    std::vector<unsigned int> v( digits, d );
+    return IntList( v );
+}
+
+BOOST_AUTO_TEST_CASE(intlistparallel_add_subtract_tests)
+{
+    WorkStealingPool pool(4);
+
+    {   //
+        // double-checking random values against the sequential operators, with
+        // blocks small enough that there are lots of them
+        //
+        std::srand(time(nullptr));
+
+        for ( int i=0; i < 200; i++ ) {
+            auto x = random_int_list( 1 + std::rand() % 2000 );
+            auto y = random_int_list( 1 + std::rand() % 2000 );
+            if ( x < y )
+                std::swap( x, y );
+            unsigned long block = 1 + std::rand() % 40;
+
+            BOOST_CHECK( add_parallel( x, y, pool, block ) == x + y );
+            BOOST_CHECK( add_parallel( y, x, pool, block ) == x + y );
+            BOOST_CHECK( subtract_parallel( x, y, pool, block ) == x - y );
+        }
+    }
+
+    {   //
+        // carries and borrows that have to ripple through every block
+        //
+        auto nines = repeated_digit( 1000, 9 );                    // 10^1000 - 1
+        auto sum = add_parallel( nines, IntList(1), pool, 7 );     // 10^1000
+        BOOST_CHECK( sum.size() == 1001 );
+        BOOST_CHECK( sum == nines + IntList(1) );
+
+        BOOST_CHECK( subtract_parallel( sum, IntList(1), pool, 7 ) == nines );
+        BOOST_CHECK( subtract_parallel( sum, nines, pool, 7 ) == IntList(1) );
+        BOOST_CHECK( subtract_parallel( nines, nines, pool, 7 ) == IntList(0) );
+        BOOST_CHECK( add_parallel( nines, nines, pool, 7 ) == nines + nines );
+    }
+
+    {   //
+        // small operands, bad block sizes, and negative differences
+        //
+        BOOST_CHECK( add_parallel( IntList(999), IntList(1), pool ) == IntList(1000) );
+        BOOST_CHECK( subtract_parallel( IntList(1000), IntList(1), pool, 1 ) == IntList(999) );
+        BOOST_CHECK_THROW( add_parallel( IntList(1), IntList(1), pool, 0 ), std::invalid_argument );
+        BOOST_CHECK_THROW( subtract_parallel( IntList(1), IntList(2), pool, 1 ), std::invalid_argument );
+
+        auto big = random_int_list( 500 );
+        BOOST_CHECK_THROW( subtract_parallel( big, shifted( big, 1 ), pool, 16 ), std::invalid_argument );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// to_str_parallel / write_chars_parallel
+// *******************************************************************************
+//
+// Each digit's character depends on nothing but the digit, so the output is
+// allocated once and every block of it is written independently. (The second
+// writes into any buffer of il.size() chars, such as a mapped file.)
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::string to_str_parallel( const IntList& il, WorkStealingPool& pool, unsigned long block_digits )
+{
+    std::string str( il.size(), '0' );
+    write_chars_parallel( il, str.data(), pool, block_digits );
+    return str;
+}
+//
+void write_chars_parallel( const IntList& il, char* out, WorkStealingPool& pool, unsigned long block_digits )
+{
+    if ( block_digits == 0 )
+        throw std::invalid_argument( "block_digits must be > 0" );
+
+    const unsigned long n = il.size();
+    if ( n < block_digits*2 )
+        return il.write_chars( out, 0, n );
+
+    const unsigned long blocks = (n + block_digits - 1) / block_digits;
+
+    for_each_block( pool, blocks, [&]( unsigned long k ) {
+        const unsigned long first = k*block_digits;
+        il.write_chars( out + first, first, std::min( block_digits, n - first ) );
+    } );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlistparallel_to_str_tests)
+{
+    WorkStealingPool pool(4);
+
+    for ( int i=0; i < 100; i++ ) {
+        auto x = random_int_list( 1 + std::rand() % 5000 );
+        unsigned long block = 1 + std::rand() % 100;
+        BOOST_CHECK( to_str_parallel( x, pool, block ) == x.to_str() );
+    }
+
+    BOOST_CHECK( to_str_parallel( IntList(0), pool, 1 ) == "0" );
+    BOOST_CHECK( to_str_parallel( IntList(1234567), pool ) == "1234567" );
+    BOOST_CHECK_THROW( to_str_parallel( IntList(1), pool, 0 ), std::invalid_argument );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// from_str_parallel
+// *******************************************************************************
+//
+// The leading zeros are skipped up front (so every block knows where its
+// digits land), then each block is run through IntList::parse_digits on its
+// own. Any block that stops short has found a bad char; the lowest one wins,
+// so the error names the same char the sequential constructor would.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList from_str_parallel( std::string_view s, WorkStealingPool& pool, unsigned long block_digits )
+{
+    if ( block_digits == 0 )
+        throw std::invalid_argument( "block_digits must be > 0" );
+
+    if ( s.size() < block_digits*2 )
+        return IntList( s );
+
+    const char* last  = s.data() + s.size();
+    const char* first = std::find_if( s.data(), last-1, []( char c ) { return c != '0'; } );
+    const unsigned long n = last - first;
+
+    std::vector<IntList::value_type> digits( n );
+    const unsigned long blocks = (n + block_digits - 1) / block_digits;
+    std::vector<const char*> stops( blocks );
+
+    for_each_block( pool, blocks, [&]( unsigned long k ) {
+        const unsigned long lo = k*block_digits;
+        const unsigned long hi = std::min( n, lo + block_digits );
+        stops[k] = IntList::parse_digits( first + lo, first + hi, digits.data() + lo );
+    } );
+
+    for ( unsigned long k = 0; k < blocks; ++k )
+        if ( stops[k] != first + std::min( n, (k+1)*block_digits ) )
+            throw std::invalid_argument( std::string("'") + *stops[k] + "' is not a valid decimal digit" );
+
+    return IntList( std::move(digits) );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(intlistparallel_from_str_tests)
+{
+    WorkStealingPool pool(4);
+
+    for ( int i=0; i < 100; i++ ) {
+        auto s = random_int_list( 1 + std::rand() % 5000 ).to_str();
+        s.insert( 0, std::rand() % 20, '0' );
+        unsigned long block = 1 + std::rand() % 100;
+        BOOST_CHECK( from_str_parallel( s, pool, block ) == IntList( s ) );
+    }
+
+    BOOST_CHECK( from_str_parallel( "0000000000", pool, 1 ) == IntList(0) );
+    BOOST_CHECK( from_str_parallel( "1234567", pool ) == IntList(1234567) );
+
+    {   //
+        // bad chars are reported the same way the constructor reports them
+        //
+        auto s = random_int_list( 1000 ).to_str();
+        s[700] = 'x';
+        s[300] = '?';
+        try {
+            from_str_parallel( s, pool, 16 );
+            BOOST_CHECK( false );
+        }
+        catch ( const std::invalid_argument& e ) {
+            BOOST_CHECK( std::string( e.what() ) == "'?' is not a valid decimal digit" );
+        }
+        BOOST_CHECK_THROW( from_str_parallel( "", pool, 1 ), std::invalid_argument );
+        BOOST_CHECK_THROW( from_str_parallel( "12", pool, 0 ), std::invalid_argument );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
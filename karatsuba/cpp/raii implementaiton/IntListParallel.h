@@ -0,0 +1,50 @@
+//
+// IntListParallel.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// multi-threaded versions of the integer list operations that are otherwise a
+// single sequential pass over the digits (so they don't become the serial
+// bottleneck of an otherwise parallel multiply).
+//
+#ifndef __int_list_parallel_h
+#define __int_list_parallel_h
+
+#include <string>
+#include <string_view>
+
+#include "IntList.h"
+#include "WorkStealingPool.h"
+
+// digits per block for the parallel add/subtract; operands shorter than two
+// blocks aren't worth splitting and just use the sequential operators.
+const unsigned long default_parallel_add_block_digits = 1UL << 16;
+
+// a + b and a - b, with the operands cut into blocks that are summed on the
+// pool independently and then stitched together by their carries. a - b
+// throws std::invalid_argument if b > a, exactly like operator-.
+IntList add_parallel(const IntList& a, const IntList& b,
+                     WorkStealingPool& pool = WorkStealingPool::shared(),
+                     unsigned long block_digits = default_parallel_add_block_digits);
+IntList subtract_parallel(const IntList& a, const IntList& b,
+                          WorkStealingPool& pool = WorkStealingPool::shared(),
+                          unsigned long block_digits = default_parallel_add_block_digits);
+
+// il.to_str(), with the output string cut into blocks that are filled in on
+// the pool
+const unsigned long default_parallel_str_block_digits = 1UL << 20;
+void write_chars_parallel(const IntList& il, char* out,
+                          WorkStealingPool& pool = WorkStealingPool::shared(),
+                          unsigned long block_digits = default_parallel_str_block_digits);
+std::string to_str_parallel(const IntList& il,
+                            WorkStealingPool& pool = WorkStealingPool::shared(),
+                            unsigned long block_digits = default_parallel_str_block_digits);
+
+// IntList(s), with the string cut into blocks that are validated and converted
+// on the pool
+const unsigned long default_parallel_parse_block_digits = 1UL << 20;
+IntList from_str_parallel(std::string_view s,
+                          WorkStealingPool& pool = WorkStealingPool::shared(),
+                          unsigned long block_digits = default_parallel_parse_block_digits);
+
+#endif // __int_list_parallel_h
@@ -0,0 +1,51 @@
+//
+// IntListTestUtils.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// helpers shared by the unit tests of the integer list classes and the
+// multiplication routines built on them; only included in unit test builds.
+//
+#ifndef __int_list_test_utils_h
+#define __int_list_test_utils_h
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "IntList.h"
+
+// random value of exactly 'digits' digits (no leading zero)
+inline IntList random_int_list( unsigned long digits )
+{
+    std::vector<unsigned int> v( digits );
+    for ( auto& d : v )
+        d = std::rand() % 10;
+    v[0] = 1 + std::rand() % 9;
+    return IntList( v );
+}
+
+// product(i) for every i below count, worked out by 'threads' threads at once
+// (thread t taking t, t+threads, ...), for tests of things meant to be shared
+// between threads; the results are checked back on the test's own thread,
+// since Boost.Test's checks aren't thread-safe
+template<typename F>
+std::vector<IntList> products_between_threads( int count, F product, int threads = 4 )
+{
+    std::vector<std::vector<IntList>> by_thread( threads );
+    std::vector<std::thread> running;
+    for ( int t = 0; t < threads; ++t )
+        running.emplace_back( [&, t] {
+            for ( int i = t; i < count; i += threads )
+                by_thread[t].push_back( product( i ) );
+        } );
+    for ( auto& r : running )
+        r.join();
+
+    std::vector<IntList> products;
+    for ( int i = 0; i < count; ++i )
+        products.push_back( std::move( by_thread[i % threads][i / threads] ) );
+    return products;
+}
+
+#endif // __int_list_test_utils_h
@@ -0,0 +1,496 @@
+//
+// MulPlan.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// class definitions for a reusable multiplication plan (using RAII patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_MULPLAN_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp MulPlan.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_MULPLAN_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE MulPlan Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_MULPLAN_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+#include "IntListAccumulator.h"
+#include "FixedIntList.h"
+#include "WorkStealingPool.h"
+#include "karatsuba.h"
+#include "MulPlan.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// ===============================================================================
+// class MulPlan constructors
+// ===============================================================================
+
+// *******************************************************************************
+// MulPlan::MulPlan / MulPlan::plan_square
+// *******************************************************************************
+//
+// Operands within a factor of two of each other get the karatsuba recursion
+// (the shorter padded out to the longer, as karatsuba does). Further apart than
+// that, padding would mostly be multiplying zeros, so the longer one is cut
+// into pieces as long as the shorter, each multiplied by the same (square)
+// plan and added in at its offset.
+//
+// Forking is planned by levels: every forked level triples the tasks in
+// flight, so the top levels fork just deep enough to give each thread
+// something (if they're longer than the parallel cutoff); chunked plans count
+// their pieces as tasks first.
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+MulPlan::MulPlan( unsigned long x_digits, unsigned long y_digits, unsigned int threads ) :
+    x_max( x_digits ), y_max( y_digits ), thread_count( std::max( threads, 1u ) )
+{
+    if ( x_digits == 0 || y_digits == 0 )
+        throw std::invalid_argument( "can't plan for empty operands" );
+
+    auto fork_levels_for = []( unsigned long threads ) {
+        unsigned int levels = 0;
+        for ( unsigned long tasks = 1; tasks < threads; tasks *= 3 )
+            ++levels;
+        return levels;
+    };
+
+    std::map<std::pair<unsigned long, unsigned int>, int> planned;
+    auto longer  = std::max( x_digits, y_digits );
+    auto shorter = std::min( x_digits, y_digits );
+
+    if ( longer <= mul_plan_kernel_digits || longer < shorter*2 ) {
+        plan_square( longer, fork_levels_for( thread_count ), planned );
+        return;
+    }
+
+    auto pieces = longer/shorter + (longer%shorter ? 1 : 0);
+    steps.push_back( { longer, mul_algorithm::chunked, shorter } );
+    steps[0].fork = thread_count > 1;
+    steps[0].x_longer = x_digits > y_digits;
+
+    auto piece_threads = steps[0].fork ? (thread_count + pieces - 1) / pieces : 1;
+    int piece = plan_square( shorter, fork_levels_for( piece_threads ), planned );
+    steps[0].hi = piece;
+    steps[0].scratch_digits = steps[piece].scratch_digits;
+}
+//
+int MulPlan::plan_square( unsigned long digits, unsigned int fork_levels,
+                          std::map<std::pair<unsigned long, unsigned int>, int>& planned )
+{
+    auto key = std::make_pair( digits, fork_levels );
+    if ( auto p = planned.find( key ); p != planned.end() )
+        return p->second;
+
+    int s = steps.size();
+    steps.push_back( { digits, mul_algorithm::kernel } );
+    planned[key] = s;
+    if ( digits <= mul_plan_kernel_digits )
+        return s;
+
+    auto m = karatsuba_split_point( digits );
+    bool fork = fork_levels > 0 && digits > default_parallel_cutoff_digits;
+    auto next = fork ? fork_levels - 1 : 0;
+
+    // (the sums of the halves can carry into one more digit)
+    int hi  = plan_square( digits - m, next, planned );
+    int lo  = plan_square( m,          next, planned );
+    int sum = plan_square( m + 1,      next, planned );
+
+    auto& st = steps[s];
+    st.algorithm = mul_algorithm::karatsuba;
+    st.m = m;
+    st.fork = fork;
+    st.hi = hi;
+    st.lo = lo;
+    st.sum = sum;
+    st.scratch_digits = digits*2 + 1;   // (the biggest combine, this one's own)
+    return s;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_mul_plan_shape )
+{
+    {   //
+        // the shapes it picks
+        //
+        BOOST_CHECK( MulPlan( 20, 32 ).shape().size() == 1 );
+        BOOST_CHECK( MulPlan( 20, 32 ).shape()[0].algorithm == mul_algorithm::kernel );
+
+        MulPlan square( 1000, 700 );
+        BOOST_CHECK( square.shape()[0].algorithm == mul_algorithm::karatsuba );
+        BOOST_CHECK( square.shape()[0].digits == 1000 && square.shape()[0].m == 500 );
+        BOOST_CHECK( square.shape().size() < 40 );      // (lengths repeat all the way down)
+        BOOST_CHECK( square.scratch_digits() == 2001 );
+
+        MulPlan lopsided( 100, 5000 );
+        BOOST_CHECK( lopsided.shape()[0].algorithm == mul_algorithm::chunked );
+        BOOST_CHECK( lopsided.shape()[0].m == 100 && !lopsided.shape()[0].x_longer );
+
+        MulPlan serial( 100000, 100000 ), parallel( 100000, 100000, 4 );
+        BOOST_CHECK( std::none_of( serial.shape().begin(), serial.shape().end(), []( auto& s ) { return s.fork; } ) );
+        BOOST_CHECK( parallel.shape()[0].fork );     // (4 threads: two levels, of 3 and then 9 tasks)
+        BOOST_CHECK( std::all_of( parallel.shape().begin(), parallel.shape().end(),
+                                  []( auto& s ) { return !s.fork || s.digits >= 50000; } ) );
+
+        BOOST_CHECK_THROW( MulPlan( 0, 10 ), std::invalid_argument );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class MulPlan methods
+// ===============================================================================
+
+// *******************************************************************************
+// MulPlan::workspace
+// *******************************************************************************
+//
+// Each run of a plan (and each task it forks) gets one of these: an
+// accumulator sized up front for the biggest combine under it, which does all
+// its combines, and for every karatsuba step under it, lists sized for the
+// halves (and their sums) of both operands, which every split at that step is
+// made into. A step is never under way twice at once in one run (its
+// sub-products are all shorter), so one set each does, and the recursion
+// itself allocates nothing for its splits.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+struct MulPlan::workspace
+{
+    struct operand_halves
+    {
+        karatsuba_halves x, y;
+    };
+
+    IntListAccumulator scratch;
+    std::vector<std::optional<operand_halves>> halves;     // (by step)
+
+    workspace( const MulPlan& plan, int top );
+};
+//
+MulPlan::workspace::workspace( const MulPlan& plan, int top ) :
+    scratch( plan.steps[top].scratch_digits ), halves( plan.steps.size() )
+{
+    auto sized = []( const step& st ) {
+        karatsuba_halves h { IntList( 0 ), IntList( 0 ), IntList( 0 ) };
+        h.hi.reserve( st.digits - st.m );
+        h.lo.reserve( st.m );
+        h.sum.reserve( st.m + 1 );
+        return h;
+    };
+
+    // (every karatsuba step no longer than the top one; a few more than are
+    // under it, maybe, but there are only a few dozen steps)
+    for ( std::size_t s = 0; s < plan.steps.size(); ++s ) {
+        const auto& st = plan.steps[s];
+        if ( st.algorithm == mul_algorithm::karatsuba && st.digits <= plan.steps[top].digits )
+            halves[s] = operand_halves { sized( st ), sized( st ) };
+    }
+}
+
+
+
+// *******************************************************************************
+// MulPlan::execute / MulPlan::run
+// *******************************************************************************
+//
+// The operands' sums only need a step's extra digit when one of them carries;
+// when neither does, their product goes to the m-digit step instead, as
+// karatsuba's own recursion would take it (otherwise the extra digit pushes
+// a third of every level just past the kernel, and on down).
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MulPlan::execute( const IntList& x, const IntList& y, IntList& out ) const
+{
+    if ( x.size() > x_max || y.size() > y_max )
+        throw std::invalid_argument( "operands are longer than the plan is for (" + std::to_string( x_max ) +
+                                     " and " + std::to_string( y_max ) + " digits)" );
+
+    workspace w( *this, 0 );
+    out = run( 0, x, y, w );
+}
+//
+IntList MulPlan::run( int s, const IntList& x, const IntList& y, workspace& w ) const
+{
+    const auto& st = steps[s];
+
+    switch ( st.algorithm ) {
+
+    case mul_algorithm::kernel:
+        return ( FixedIntList<mul_plan_kernel_digits>( x ) * FixedIntList<mul_plan_kernel_digits>( y ) ).to_int_list();
+
+    case mul_algorithm::karatsuba: {
+        auto& [xh, yh] = *w.halves[s];
+        split_into_halves( x, st.digits, xh );
+        split_into_halves( y, st.digits, yh );
+        const IntList& a = xh.hi;
+        const IntList& b = xh.lo;
+        const IntList& c = yh.hi;
+        const IntList& d = yh.lo;
+        int sum = xh.sum.size() <= st.m && yh.sum.size() <= st.m ? st.lo : st.sum;
+
+        if ( !st.fork ) {
+            auto    s1 = run( st.hi, a,      c,      w );
+            auto    s2 = run( st.lo, b,      d,      w );
+            auto s1xs2 = run( sum,   xh.sum, yh.sum, w );
+            return karatsuba_join( s1, s2, s1xs2, st.m, w.scratch );
+        }
+
+        auto& pool = WorkStealingPool::shared();
+        std::optional<WorkStealingPool::task_handle<IntList>> s1_task, s2_task;
+        IntList s1xs2( 0 ), s1( 0 ), s2( 0 );
+        try {
+            s1_task = pool.fork( [&] {
+                workspace own( *this, st.hi );
+                return run( st.hi, a, c, own );
+            } );
+            s2_task = pool.fork( [&] {
+                workspace own( *this, st.lo );
+                return run( st.lo, b, d, own );
+            } );
+            s1xs2 = run( sum, xh.sum, yh.sum, w );
+            s1    = pool.join( *s1_task );
+            s2    = pool.join( *s2_task );
+        }
+        catch (...) {
+            // the forks (the ones that got made) still refer to a..d; let
+            // them finish before those go
+            if ( s1_task ) pool.wait( *s1_task );
+            if ( s2_task ) pool.wait( *s2_task );
+            throw;
+        }
+        return karatsuba_join( s1, s2, s1xs2, st.m, w.scratch );
+    }
+
+    case mul_algorithm::chunked: {
+        const IntList& longer  = st.x_longer ? x : y;
+        const IntList& shorter = st.x_longer ? y : x;
+
+        auto pieces = lsd_pieces( longer, st.m );
+        IntListAccumulator total( longer.size() + shorter.size() + 1 );
+        if ( !st.fork || pieces.size() == 1 ) {
+            for ( const auto& [piece, offset] : pieces )
+                total.add_shifted( run( st.hi, piece, shorter, w ), offset );
+            return total.finish();
+        }
+
+        auto& pool = WorkStealingPool::shared();
+        std::vector<WorkStealingPool::task_handle<IntList>> tasks;
+        std::exception_ptr error;
+        try {
+            tasks.reserve( pieces.size() );
+            for ( const auto& [piece, offset] : pieces )
+                tasks.push_back( pool.fork( [&, &piece = piece] {
+                    workspace own( *this, st.hi );
+                    return run( st.hi, piece, shorter, own );
+                } ) );
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        // every task is finished before any exception goes on (they refer to
+        // the pieces and the shorter operand); after the first, the rest are
+        // only waited for
+        for ( std::size_t i = 0; i < tasks.size(); ++i )
+            try {
+                if ( error )
+                    pool.wait( tasks[i] );
+                else
+                    total.add_shifted( pool.join( tasks[i] ), pieces[i].second );
+            }
+            catch (...) {
+                if ( !error )
+                    error = std::current_exception();
+            }
+
+        if ( error )
+            std::rethrow_exception( error );
+        return total.finish();
+    }
+    }
+
+    throw std::logic_error( "unknown step algorithm" );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_mul_plan_execute )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // products against karatsuba, for operands as long as the plan and
+        // shorter, balanced and lopsided either way round
+        //
+        for ( auto [nx, ny] : { std::pair( 1ul, 1ul ), std::pair( 32ul, 7ul ), std::pair( 33ul, 33ul ),
+                                std::pair( 500ul, 300ul ), std::pair( 999ul, 1000ul ), std::pair( 40ul, 1234ul ),
+                                std::pair( 3001ul, 500ul ) } ) {
+            MulPlan plan( nx, ny );
+            for ( int i=0; i < 3; i++ ) {
+                auto x = random_int_list( i == 0 ? nx : 1 + std::rand() % nx );
+                auto y = random_int_list( i == 0 ? ny : 1 + std::rand() % ny );
+                IntList out( 0 );
+                plan.execute( x, y, out );
+                BOOST_CHECK( out == karatsuba( x, y ) );
+            }
+        }
+
+        // all nines, for every carry there is
+        IntList nines( std::vector<IntList::value_type>( 777, 9 ) );
+        IntList out( 0 );
+        MulPlan( 777, 777 ).execute( nines, nines, out );
+        BOOST_CHECK( out == karatsuba( nines, nines ) );
+
+        MulPlan small( 10, 10 );
+        BOOST_CHECK_THROW( small.execute( random_int_list( 11 ), IntList( 5 ), out ), std::invalid_argument );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_mul_plan_execute_forked )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // forking plans (on the shared pool), square and chunked
+        //
+        for ( auto [nx, ny] : { std::pair( 9000ul, 8000ul ), std::pair( 2500ul, 12000ul ) } ) {
+            MulPlan plan( nx, ny, 4 );
+            BOOST_CHECK( plan.shape()[0].fork );
+
+            auto x = random_int_list( nx ), y = random_int_list( ny );
+            IntList out( 0 );
+            plan.execute( x, y, out );
+            BOOST_CHECK( out == karatsuba( x, y ) );
+        }
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// MulPlan::size_class / MulPlan::cached
+// *******************************************************************************
+//
+// Sixteen classes per power of two (so nothing is padded by more than 1/16 of
+// its length, about a tenth on the cost), and all the kernel-sized lengths in
+// one. The cache keeps every plan it makes for the life of the program; with
+// classes that coarse there are only so many.
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+unsigned long MulPlan::size_class( unsigned long digits )
+{
+    if ( digits <= mul_plan_kernel_digits )
+        return mul_plan_kernel_digits;
+
+    unsigned long step = 1UL << ( std::bit_width( digits ) - 5 );
+    return (digits + step - 1) / step * step;
+}
+//
+std::shared_ptr<const MulPlan> MulPlan::cached( unsigned long x_digits, unsigned long y_digits, unsigned int threads )
+{
+    static std::mutex lock;
+    static std::map<std::tuple<unsigned long, unsigned long, unsigned int>, std::shared_ptr<const MulPlan>> plans;
+
+    auto key = std::make_tuple( size_class( x_digits ), size_class( y_digits ), std::max( threads, 1u ) );
+
+    std::lock_guard<std::mutex> guard( lock );
+    auto& plan = plans[key];
+    if ( !plan )
+        plan = std::make_shared<const MulPlan>( std::get<0>( key ), std::get<1>( key ), std::get<2>( key ) );
+    return plan;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_mul_plan_size_class )
+{
+    {   //
+        // size classes
+        //
+        for ( unsigned long n : { 1ul, 32ul, 33ul, 100ul, 1000ul, 65537ul, 1000000ul } ) {
+            auto c = MulPlan::size_class( n );
+            BOOST_CHECK( c >= n && c <= std::max( 32ul, n + n/16 + 1 ) );
+            BOOST_CHECK( MulPlan::size_class( c ) == c );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_mul_plan_cached )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // one plan per pair of size classes, made once
+        //
+        auto p1 = MulPlan::cached( 1000, 1001 );
+        auto p2 = MulPlan::cached( 1010, 1000 );
+        BOOST_CHECK( p1 == p2 );
+        BOOST_CHECK( p1->x_digits() >= 1010 && p1->y_digits() >= 1001 );
+        BOOST_CHECK( MulPlan::cached( 1000, 1000, 4 ) != p1 );
+
+        // shared between threads
+        std::vector<IntList> xs, ys;
+        for ( int i=0; i < 8; i++ ) {
+            xs.push_back( random_int_list( 900 + std::rand() % 100 ) );
+            ys.push_back( random_int_list( 900 + std::rand() % 100 ) );
+        }
+        auto products = products_between_threads( 8, [&]( int i ) {
+            IntList out( 0 );
+            MulPlan::cached( 1000, 1000 )->execute( xs[i], ys[i], out );
+            return out;
+        } );
+        for ( int i=0; i < 8; i++ )
+            BOOST_CHECK( products[i] == karatsuba( xs[i], ys[i] ) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
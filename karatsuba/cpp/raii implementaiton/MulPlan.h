@@ -0,0 +1,102 @@
+//
+// MulPlan.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class declaration for a reusable multiplication plan (using RAII patterns):
+// every decision karatsuba makes about operands of a given length, made once
+// up front, so running it over and over is just the arithmetic.
+//
+#ifndef __mul_plan_h
+#define __mul_plan_h
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "IntList.h"
+
+// what a step of a plan does
+enum class mul_algorithm
+{
+    kernel,         // multiply out with the fixed-size schoolbook kernel
+    karatsuba,      // split in two, and three half-size sub-products
+    chunked         // one operand is much the longer: multiply it a piece at a time
+};
+
+// steps this long or shorter are multiplied out by the kernel
+const unsigned long mul_plan_kernel_digits = 32;
+
+class MulPlan
+//
+// The whole recursion for x*y with x up to x_digits long and y up to y_digits,
+// worked out in advance: at each step its algorithm, where it splits, which
+// sub-products it forks onto the shared pool, and the scratch its combines
+// and splits need. Steps work at a nominal length (with the operands
+// zero-padded to it), so the shape doesn't depend on the digits, and one plan
+// does for any operands up to its lengths. Each sub-product length only gets
+// planned once, so the plan is only a few dozen steps even for millions of
+// digits.
+//
+// Plans don't look at the digits, so don't spot sparse operands the way
+// karatsuba() does; they're for dense values of sizes that come up again and
+// again.
+//
+{
+public:
+    struct step
+    {
+        unsigned long digits;           // nominal length (of the longer operand, if chunked)
+        mul_algorithm algorithm;
+        unsigned long m = 0;            // karatsuba: split point; chunked: piece length
+        bool fork = false;              // sub-products (or pieces) run as pool tasks
+        bool x_longer = false;          // chunked: x is the one cut into pieces
+        int hi = -1, lo = -1, sum = -1; // karatsuba: sub-product steps; chunked: hi is the pieces' step
+        unsigned long scratch_digits = 0;   // accumulator room for this step's combines (and everything under it)
+    };
+
+private:
+    unsigned long x_max, y_max;
+    unsigned int thread_count;
+    std::vector<step> steps;            // the top one first
+
+    int plan_square( unsigned long digits, unsigned int fork_levels,
+                     std::map<std::pair<unsigned long, unsigned int>, int>& planned );
+
+    struct workspace;                   // what a run (or a task it forks) works in
+    IntList run( int s, const IntList& x, const IntList& y, workspace& w ) const;
+
+public:
+    // constructors (threads > 1 forks the top of the recursion onto the shared
+    // pool, just deep enough to keep that many busy)
+    MulPlan( unsigned long x_digits, unsigned long y_digits, unsigned int threads = 1 );
+
+    // copy & move semantics
+    MulPlan( const MulPlan& ) = delete;
+    MulPlan( MulPlan&& ) = default;
+    MulPlan& operator=( const MulPlan& ) = delete;
+    MulPlan& operator=( MulPlan&& ) = default;
+
+    // out = x*y; throws std::invalid_argument if either is longer than planned for
+    void execute( const IntList& x, const IntList& y, IntList& out ) const;
+
+    // the plan itself
+    unsigned long x_digits() const { return x_max; }
+    unsigned long y_digits() const { return y_max; }
+    unsigned int threads() const { return thread_count; }
+    const std::vector<step>& shape() const { return steps; }
+    unsigned long scratch_digits() const { return steps.front().scratch_digits; }
+
+    // lengths are planned for in classes, each up to 1/16 longer than the
+    // one before: the smallest class holding 'digits'
+    static unsigned long size_class( unsigned long digits );
+
+    // a plan for the size classes of these lengths, made the first time it's
+    // asked for and shared from then on (each execute() has scratch of its
+    // own, so threads can run the same plan at once)
+    static std::shared_ptr<const MulPlan> cached( unsigned long x_digits, unsigned long y_digits,
+                                                  unsigned int threads = 1 );
+};
+
+#endif // __mul_plan_h
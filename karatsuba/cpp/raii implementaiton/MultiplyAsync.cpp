@@ -0,0 +1,316 @@
+//
+// MultiplyAsync.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// Implementation of the coroutine Karatsuba multiply
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_MULTIPLYASYNC_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp MultiplyAsync.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_MULTIPLYASYNC_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE MultiplyAsync Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_MULTIPLYASYNC_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <deque>
+
+#include "karatsuba.h"
+#include "MultiplyAsync.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// ===============================================================================
+// class multiply_task methods
+// ===============================================================================
+
+// *******************************************************************************
+// multiply_task: moving, awaiting, starting, and the result
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+multiply_task& multiply_task::operator=( multiply_task&& that )
+{
+    if ( this != &that ) {
+        if ( coro )
+            coro.destroy();
+        coro = std::exchange( that.coro, nullptr );
+    }
+    return *this;
+}
+
+multiply_task::~multiply_task()
+{
+    if ( coro )
+        coro.destroy();
+}
+
+std::coroutine_handle<> multiply_task::await_suspend( std::coroutine_handle<> awaiting ) noexcept
+{
+    coro.promise().continuation = awaiting;
+    return coro;
+}
+
+IntList multiply_task::await_resume()
+{
+    return result();
+}
+
+void multiply_task::start()
+{
+    if ( !coro )
+        throw std::logic_error( "task has been moved from" );
+    if ( !coro.done() )
+        coro.resume();
+}
+
+IntList multiply_task::result()
+{
+    if ( !done() )
+        throw std::logic_error( "task hasn't finished (is it waiting on its scheduler?)" );
+
+    auto& p = coro.promise();
+    if ( p.error )
+        std::rethrow_exception( p.error );
+    return std::move( *p.value );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_task )
+{
+    {   //
+        // nothing to show until it's been started and run to the end
+        //
+        auto task = multiply_async( IntList(6), IntList(7) );
+        BOOST_CHECK( !task.done() );
+        BOOST_CHECK_THROW( task.result(), std::logic_error );
+        task.start();
+        BOOST_CHECK( task.done() );
+        BOOST_CHECK( task.result() == IntList(42) );
+
+        auto moved = std::move( task );
+        BOOST_CHECK( !task.done() );
+        BOOST_CHECK_THROW( task.start(), std::logic_error );
+
+        multiply_task other = multiply_async( IntList(2), IntList(3) );
+        other = multiply_async( IntList(4), IntList(5) );
+        BOOST_CHECK( other.get() == IntList(20) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// Calculate a product by Karatsuba multiplication, as a coroutine.
+//
+// Each level of the recursion is its own coroutine, co_awaiting its three
+// sub-products one after another (the frames chain into each other, so going
+// down and coming back up doesn't grow the stack). Before every subproblem,
+// and before each join, there's a boundary: the place where it can be
+// suspended to the scheduler, and where cancellation is noticed.
+//
+// Progress is in shares of the whole: the top gets 1, and each split hands its
+// share on to its three sub-products in proportion to their karatsuba_cost.
+// Slices add their share to the total when they finish, so it only ever goes
+// up and is exactly 1 at the end.
+// *******************************************************************************
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+namespace {
+
+struct async_context
+{
+    std::stop_token token;
+    multiply_async_options options;
+    double done = 0;
+
+    void check() const
+    {
+        if ( token.stop_requested() )
+            throw multiply_cancelled();
+    }
+
+    void advance( double share )
+    {
+        done = std::min( 1.0, done + share );
+        if ( options.progress )
+            options.progress( done );
+    }
+
+    // co_await at a subproblem boundary
+    struct boundary_awaiter
+    {
+        async_context& ctx;
+
+        bool await_ready() const { ctx.check(); return !ctx.options.scheduler; }
+        void await_suspend( std::coroutine_handle<> h ) const { ctx.options.scheduler( h ); }
+        void await_resume() const { ctx.check(); }
+    };
+    boundary_awaiter boundary() { return { *this }; }
+};
+
+multiply_task multiply_node( IntList x, IntList y, async_context& ctx, double share, bool top )
+{
+    co_await ctx.boundary();
+
+    auto digits = std::max( x.size(), y.size() );
+    if ( digits <= ctx.options.slice_digits || digits < 2 ||
+         (top && karatsuba_goes_sparse( x, y )) ) {
+        auto product = karatsuba( x, y );
+        ctx.advance( share );
+        co_return product;
+    }
+
+    auto step = karatsuba_split( x, y );
+    x = IntList( 0 );
+    y = IntList( 0 );
+
+    double c1 = karatsuba_cost( step.s1.first.size(),    step.s1.second.size()    );
+    double c2 = karatsuba_cost( step.s2.first.size(),    step.s2.second.size()    );
+    double c3 = karatsuba_cost( step.s1xs2.first.size(), step.s1xs2.second.size() );
+    double total = c1 + c2 + c3;
+
+    auto s1    = co_await multiply_node( std::move( step.s1.first ),    std::move( step.s1.second ),    ctx,
+                                         share * c1/total, false );
+    auto s2    = co_await multiply_node( std::move( step.s2.first ),    std::move( step.s2.second ),    ctx,
+                                         share * c2/total, false );
+    auto s1xs2 = co_await multiply_node( std::move( step.s1xs2.first ), std::move( step.s1xs2.second ), ctx,
+                                         share * c3/total, false );
+
+    co_await ctx.boundary();
+    co_return karatsuba_join( s1, s2, s1xs2, step.m );
+}
+
+}
+
+multiply_task multiply_async( IntList x, IntList y, std::stop_token token, multiply_async_options options )
+{
+    // (the context lives in this frame, which outlives all the ones below it)
+    async_context ctx { std::move(token), std::move(options) };
+    co_return co_await multiply_node( std::move(x), std::move(y), ctx, 1.0, true );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+// a coroutine awaiting a multiply, the way a request handler would
+static multiply_task handler( const IntList& x, const IntList& y, std::stop_token token, multiply_async_options options )
+{
+    auto product = co_await multiply_async( x.clone(), y.clone(), token, options );
+    co_return product;
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_async )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // straight through (no scheduler), with progress climbing to exactly 1
+        //
+        for ( unsigned long digits : { 1ul, 30ul, 500ul, 3000ul } ) {
+            auto x = random_int_list( digits );
+            auto y = random_int_list( 1 + std::rand() % digits );
+
+            std::vector<double> reports;
+            multiply_async_options options;
+            options.slice_digits = 64;
+            options.progress = [&]( double f ) { reports.push_back( f ); };
+
+            BOOST_CHECK( multiply_async( x.clone(), y.clone(), {}, options ).get() == karatsuba( x, y ) );
+            BOOST_REQUIRE( !reports.empty() );
+            BOOST_CHECK( std::is_sorted( reports.begin(), reports.end() ) );
+            BOOST_CHECK_CLOSE( reports.back(), 1.0, 1e-9 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_async_scheduled )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // two multiplies interleaved on one thread by a round-robin loop, each
+        // awaited from a handler coroutine
+        //
+        std::deque<std::coroutine_handle<>> ready;
+        multiply_async_options options;
+        options.slice_digits = 64;
+        options.scheduler = [&]( std::coroutine_handle<> h ) { ready.push_back( h ); };
+
+        auto x1 = random_int_list( 2000 ), y1 = random_int_list( 1500 );
+        auto x2 = random_int_list( 700 ),  y2 = random_int_list( 900 );
+        auto t1 = handler( x1, y1, {}, options );
+        auto t2 = handler( x2, y2, {}, options );
+        t1.start();
+        t2.start();
+        BOOST_CHECK( !t1.done() && !t2.done() );
+        BOOST_CHECK_THROW( t1.result(), std::logic_error );
+
+        int resumes = 0;
+        while ( !ready.empty() ) {
+            auto h = ready.front();
+            ready.pop_front();
+            h.resume();
+            ++resumes;
+        }
+        BOOST_CHECK( resumes > 10 );
+        BOOST_CHECK( t1.result() == karatsuba( x1, y1 ) );
+        BOOST_CHECK( t2.result() == karatsuba( x2, y2 ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_async_cancelled )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // cancelling part way through (as a deadline would)
+        //
+        std::stop_source stop;
+        double last = 0;
+        multiply_async_options options;
+        options.slice_digits = 64;
+        options.progress = [&]( double f ) {
+            last = f;
+            if ( f > 0.3 )
+                stop.request_stop();
+        };
+
+        auto x = random_int_list( 3000 ), y = random_int_list( 3000 );
+        BOOST_CHECK_THROW( handler( x, y, stop.get_token(), options ).get(), multiply_cancelled );
+        BOOST_CHECK( last > 0.3 && last < 0.5 );
+
+        // and before it even starts
+        BOOST_CHECK_THROW( multiply_async( x.clone(), y.clone(), stop.get_token() ).get(), multiply_cancelled );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
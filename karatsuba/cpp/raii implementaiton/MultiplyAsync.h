@@ -0,0 +1,112 @@
+//
+// MultiplyAsync.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// Declarations for a coroutine Karatsuba multiply: the recursion can be
+// suspended at its subproblem boundaries, cancelled there, and reports how far
+// through it is as it goes.
+//
+#ifndef __multiply_async_h
+#define __multiply_async_h
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+#include "IntList.h"
+
+// what a cancelled multiply_async throws (out of its co_await)
+struct multiply_cancelled : std::runtime_error
+{
+    multiply_cancelled() : std::runtime_error( "multiply cancelled" ) {}
+};
+
+// subproblems this long or shorter are multiplied straight through, without
+// any more boundaries inside them
+const unsigned long default_async_slice_digits = 2048;
+
+struct multiply_async_options
+{
+    // called at every boundary with the suspended multiply, which it should
+    // resume later (from an event loop, say); without one the multiply never
+    // actually suspends, and just checks for cancellation at each boundary
+    std::function<void(std::coroutine_handle<>)> scheduler;
+
+    // called with the fraction of the work done, from 0 up to 1, as each
+    // slice finishes
+    std::function<void(double)> progress;
+
+    unsigned long slice_digits = default_async_slice_digits;
+};
+
+
+
+class multiply_task
+//
+// A lazily-started coroutine computing an IntList: co_await it from another
+// coroutine, or start() it and check done() (get() does both, for when there's
+// no scheduler involved).
+//
+{
+public:
+    struct promise_type;
+
+private:
+    std::coroutine_handle<promise_type> coro;
+
+    explicit multiply_task( std::coroutine_handle<promise_type> coro ) : coro( coro ) {}
+
+public:
+    struct promise_type
+    {
+        std::optional<IntList> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        struct final_awaiter
+        {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend( std::coroutine_handle<promise_type> h ) noexcept
+            {
+                return h.promise().continuation;
+            }
+            void await_resume() noexcept {}
+        };
+
+        multiply_task get_return_object() { return multiply_task( std::coroutine_handle<promise_type>::from_promise( *this ) ); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void return_value( IntList v ) { value.emplace( std::move(v) ); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    // copy & move semantics / construction
+    multiply_task( const multiply_task& ) = delete;
+    multiply_task( multiply_task&& that ) : coro( std::exchange( that.coro, nullptr ) ) {}
+    multiply_task& operator=( const multiply_task& ) = delete;
+    multiply_task& operator=( multiply_task&& that );
+    ~multiply_task();
+
+    // awaiting it starts it, and carries on once it's finished
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend( std::coroutine_handle<> awaiting ) noexcept;
+    IntList await_resume();
+
+    // run it from ordinary code: start() runs it up to its first suspension (or
+    // the end), result() takes the product (or rethrows what it threw)
+    void start();
+    bool done() const { return coro && coro.done(); }
+    IntList result();
+    IntList get() { start(); return result(); }
+};
+
+// x*y by Karatsuba, as a coroutine; throws multiply_cancelled at the first
+// boundary after 'token' is stopped
+multiply_task multiply_async( IntList x, IntList y, std::stop_token token = {}, multiply_async_options options = {} );
+
+#endif // __multiply_async_h
@@ -0,0 +1,404 @@
+//
+// MultiplyPipeline.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// Implementation of the pipelined batch multiply
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_MULTIPLYPIPELINE_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp MultiplyPipeline.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_MULTIPLYPIPELINE_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE MultiplyPipeline Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_MULTIPLYPIPELINE_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "IntList.h"
+#include "BoundedQueue.h"
+#include "karatsuba.h"
+#include "MultiplyPipeline.h"
+
+namespace {
+
+using pipeline_clock = std::chrono::steady_clock;
+
+double seconds_since( pipeline_clock::time_point& start )
+{
+    auto now = pipeline_clock::now();
+    double s = std::chrono::duration<double>( now - start ).count();
+    start = now;
+    return s;
+}
+
+// a pair on its way through, tagged with its place in the input
+struct multiply_job
+{
+    unsigned long seq;
+    IntList x, y;
+};
+struct multiply_result
+{
+    unsigned long seq;
+    IntList product;
+};
+
+// the sequence numbers the reader may hand out: never more than 'width' past
+// the next one the writer is waiting for, so the products it has to hold back
+// (and everything else between the two) stay bounded even when one slow pair
+// holds up the line
+class reorder_window
+{
+    std::mutex lock;
+    std::condition_variable moved;
+    unsigned long next_out = 0;
+    unsigned long width;
+    unsigned long widest = 0;
+    bool closed = false;
+
+public:
+    explicit reorder_window( std::size_t width ) : width( width ) {}
+
+    // wait until seq is inside the window; false if the pipeline is stopping
+    bool admit( unsigned long seq )
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        moved.wait( guard, [&]{ return closed || seq < next_out + width; } );
+        widest = std::max( widest, seq + 1 - next_out );
+        return !closed;
+    }
+
+    // the writer has written everything before 'next'
+    void written( unsigned long next )
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        next_out = next;
+        moved.notify_all();
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        closed = true;
+        moved.notify_all();
+    }
+
+    // the most pairs that were ever in flight at once
+    unsigned long peak()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        return widest;
+    }
+};
+
+// the first exception any stage throws; throwing closes every queue (and the
+// window), so the rest of the stages run out of work and stop
+class pipeline_failure
+{
+    std::mutex lock;
+    std::exception_ptr first;
+
+public:
+    template<typename... Queues>
+    void record( Queues&... queues )
+    {
+        {
+            std::lock_guard<std::mutex> guard( lock );
+            if ( !first )
+                first = std::current_exception();
+        }
+        ( queues.close(), ... );
+    }
+
+    void rethrow_if_any()
+    {
+        if ( first )
+            std::rethrow_exception( first );
+    }
+};
+
+}
+
+
+
+// *******************************************************************************
+// Multiply a whole file's worth of pairs, with I/O and compute overlapped.
+//
+//     reader ---> [jobs] ---> multiply workers ---> [results] ---> writer
+//
+// The reader splits the input into lines and parses each pair; 'workers'
+// threads take pairs off the jobs queue and multiply them; the writer puts the
+// products back in input order (holding any that finish early) and formats
+// them out. The reader also has to wait for its pair to fall within
+// queue_depth of the next one the writer needs, so at most queue_depth pairs
+// are anywhere between the two (queued, being multiplied, or held back for
+// their turn), however big the batch is and however slow any one pair.
+//
+// Every stage keeps track of how long it spent working and how long it spent
+// blocked on its neighbours, which is what the returned stats report.
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+pipeline_stats multiply_pipeline(std::string_view input, const std::function<void(std::string_view)>& write,
+                                 unsigned int workers, std::size_t queue_depth) {
+
+    if ( workers == 0 )
+        throw std::invalid_argument( "a pipeline needs at least one multiply worker" );
+
+    BoundedQueue<multiply_job> jobs( queue_depth );
+    BoundedQueue<multiply_result> results( queue_depth );
+    reorder_window window( queue_depth );
+    pipeline_failure failure;
+
+    pipeline_stats stats;
+    stats.stages = { { "read",     1       },
+                     { "multiply", workers },
+                     { "write",    1       } };
+    auto& read_stats     = stats.stages[0];
+    auto& multiply_stats = stats.stages[1];
+    auto& write_stats    = stats.stages[2];
+    std::mutex multiply_stats_lock;
+
+    auto wall_start = pipeline_clock::now();
+
+    //
+    // reader
+    //
+    std::thread reader( [&] {
+        try {
+            auto t = pipeline_clock::now();
+            std::string_view rest = input;
+
+            for ( unsigned long line_number = 1; !rest.empty(); ++line_number ) {
+                auto end = std::min( rest.find('\n'), rest.size() );
+                auto line = rest.substr( 0, end );
+                rest.remove_prefix( std::min( end+1, rest.size() ) );
+
+                auto is_space = []( char c ) { return c == ' ' || c == '\t' || c == '\r'; };
+                std::string_view tokens[3];
+                int count = 0;
+                for ( std::size_t i = 0; i < line.size(); ) {
+                    while ( i < line.size() && is_space( line[i] ) ) ++i;
+                    auto start = i;
+                    while ( i < line.size() && !is_space( line[i] ) ) ++i;
+                    if ( i > start && count < 3 )
+                        tokens[count++] = line.substr( start, i - start );
+                }
+                if ( count == 0 )
+                    continue;
+
+                multiply_job job { read_stats.items, IntList(0), IntList(0) };
+                try {
+                    if ( count != 2 )
+                        throw std::invalid_argument( "expected two numbers" );
+                    job.x = IntList( tokens[0] );
+                    job.y = IntList( tokens[1] );
+                }
+                catch ( const std::invalid_argument& e ) {
+                    throw std::invalid_argument( "line " + std::to_string(line_number) + ": " + e.what() );
+                }
+                ++read_stats.items;
+                read_stats.busy_seconds += seconds_since( t );
+
+                bool open = window.admit( job.seq ) && jobs.push( std::move(job) );
+                read_stats.wait_seconds += seconds_since( t );
+                if ( !open )
+                    return;
+            }
+            jobs.close();
+        }
+        catch (...) {
+            failure.record( jobs, results, window );
+        }
+    } );
+
+    //
+    // multiply workers; the last one out closes the results queue
+    //
+    std::atomic<unsigned int> running { workers };
+    std::vector<std::thread> multipliers;
+    for ( unsigned int w = 0; w < workers; ++w )
+        multipliers.emplace_back( [&] {
+            pipeline_stage_stats mine;
+            try {
+                auto t = pipeline_clock::now();
+                while ( auto job = jobs.pop() ) {
+                    mine.wait_seconds += seconds_since( t );
+
+                    multiply_result result { job->seq, karatsuba( job->x, job->y ) };
+                    ++mine.items;
+                    mine.busy_seconds += seconds_since( t );
+
+                    bool open = results.push( std::move(result) );
+                    mine.wait_seconds += seconds_since( t );
+                    if ( !open )
+                        break;
+                }
+            }
+            catch (...) {
+                failure.record( jobs, results, window );
+            }
+
+            {
+                std::lock_guard<std::mutex> guard( multiply_stats_lock );
+                multiply_stats.items        += mine.items;
+                multiply_stats.busy_seconds += mine.busy_seconds;
+                multiply_stats.wait_seconds += mine.wait_seconds;
+            }
+            if ( --running == 0 )
+                results.close();
+        } );
+
+    //
+    // ordered writer (runs right here)
+    //
+    try {
+        std::map<unsigned long, IntList> early;   // finished ahead of their turn
+        unsigned long next = 0;
+        std::string text;
+
+        auto t = pipeline_clock::now();
+        while ( auto result = results.pop() ) {
+            write_stats.wait_seconds += seconds_since( t );
+
+            early.emplace( result->seq, std::move( result->product ) );
+            for ( auto p = early.find( next ); p != early.end(); p = early.find( ++next ) ) {
+                text.resize( p->second.size() + 1 );
+                p->second.write_chars( text.data(), 0, p->second.size() );
+                text.back() = '\n';
+                write( text );
+                ++write_stats.items;
+                early.erase( p );
+            }
+            window.written( next );
+            write_stats.busy_seconds += seconds_since( t );
+        }
+    }
+    catch (...) {
+        failure.record( jobs, results, window );
+    }
+
+    reader.join();
+    for ( auto& m : multipliers )
+        m.join();
+    failure.rethrow_if_any();
+
+    stats.pairs = write_stats.items;
+    stats.most_in_flight = window.peak();
+    stats.wall_seconds = std::chrono::duration<double>( pipeline_clock::now() - wall_start ).count();
+    return stats;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_pipeline_order )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // products come out in input order, whatever order the workers finish in
+        //
+        std::string input, expected;
+        for ( int i=0; i < 500; i++ ) {
+            unsigned long a = std::rand() % 100000;
+            unsigned long b = std::rand() % 100000;
+            input += std::to_string(a) + " " + std::to_string(b) + "\n";
+            expected += std::to_string(a*b) + "\n";
+
+            if ( i % 50 == 0 )
+                input += "\n  \n";     // (blank lines are skipped)
+        }
+        {   // a couple of big ones, so the workers really do finish out of order
+            std::string big( 3000, '7' );
+            input += big + "\t" + big + "\r\n";
+            expected += karatsuba( IntList(big), IntList(big) ).to_str() + "\n";
+            input += "6 7";            // (no newline at the end)
+            expected += "42\n";
+        }
+
+        for ( unsigned int workers : { 1u, 4u } )
+            for ( std::size_t depth : { std::size_t(1), std::size_t(64) } ) {
+                std::string output;
+                auto stats = multiply_pipeline( input, [&]( std::string_view s ) { output += s; }, workers, depth );
+
+                BOOST_CHECK( output == expected );
+                BOOST_CHECK( stats.pairs == 502 );
+                BOOST_CHECK( stats.stages.size() == 3 );
+                for ( auto& stage : stats.stages )
+                    BOOST_CHECK( stage.items == 502 );
+                BOOST_CHECK( stats.most_in_flight >= 1 && stats.most_in_flight <= depth );
+                BOOST_CHECK( stats.stages[1].threads == workers );
+            }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_pipeline_skewed )
+{
+    {   //
+        // one slow pair at the front can't let the rest pile up behind it
+        //
+        std::string slow( 4000, '9' );
+        std::string skewed = slow + " " + slow + "\n";
+        for ( int i=0; i < 200; i++ )
+            skewed += "3 4\n";
+
+        std::string output;
+        auto stats = multiply_pipeline( skewed, [&]( std::string_view s ) { output += s; }, 4, 3 );
+        BOOST_CHECK( stats.pairs == 201 );
+        BOOST_CHECK( stats.most_in_flight <= 3 );
+        BOOST_CHECK( output.substr( output.size() - 3 ) == "12\n" );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_pipeline_errors )
+{
+    {   //
+        // bad lines name themselves, and nothing hangs on the way out
+        //
+        std::string output;
+        auto sink = [&]( std::string_view s ) { output += s; };
+
+        try {
+            multiply_pipeline( "1 2\n3 4\n5 x\n7 8\n", sink, 2, 1 );
+            BOOST_CHECK( false );
+        }
+        catch ( const std::invalid_argument& e ) {
+            BOOST_CHECK( std::string( e.what() ) == "line 3: 'x' is not a valid decimal digit" );
+        }
+
+        BOOST_CHECK_THROW( multiply_pipeline( "1 2 3\n", sink, 2 ), std::invalid_argument );
+        BOOST_CHECK_THROW( multiply_pipeline( "1 2\n", sink, 0 ), std::invalid_argument );
+
+        // a failing writer stops everything too
+        auto failing = []( std::string_view ) { throw std::runtime_error( "disk full" ); };
+        BOOST_CHECK_THROW( multiply_pipeline( "1 2\n3 4\n", failing, 2, 1 ), std::runtime_error );
+
+        BOOST_CHECK( multiply_pipeline( "", sink, 2 ).pairs == 0 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
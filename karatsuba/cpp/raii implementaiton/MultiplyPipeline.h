@@ -0,0 +1,53 @@
+//
+// MultiplyPipeline.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// Declarations for the pipelined batch multiply: a reader stage parsing
+// operand pairs, a set of multiply workers, and an ordered writer stage, all
+// running at once with bounded queues between them.
+//
+#ifndef __multiply_pipeline_h
+#define __multiply_pipeline_h
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// what one stage of the pipeline did
+struct pipeline_stage_stats
+{
+    std::string name;
+    unsigned int threads = 1;
+    unsigned long items = 0;
+    double busy_seconds = 0;    // doing its own work (summed over its threads)
+    double wait_seconds = 0;    // blocked on an empty input or a full output queue
+
+    // items per second the stage could keep up with if it never waited; the
+    // stage with the lowest is the bottleneck
+    double throughput() const { return busy_seconds > 0 ? items * threads / busy_seconds : 0; }
+};
+
+struct pipeline_stats
+{
+    std::vector<pipeline_stage_stats> stages;   // reader, multiply, writer
+    double wall_seconds = 0;
+    unsigned long pairs = 0;
+    unsigned long most_in_flight = 0;           // pairs between the reader and the writer at once
+};
+
+// Multiply every pair in 'input' (one "X Y" pair of decimal numbers per line;
+// blank lines are skipped) and hand each product to 'write', followed by a
+// newline, in input order. 'workers' threads multiply while the reader parses
+// ahead and the writer formats behind them; at most 'queue_depth' pairs are in
+// flight between the reader and the writer (so it wants to be at least
+// 'workers' to keep them all busy). Bad input throws std::invalid_argument naming the
+// line, once the stages have all stopped.
+const std::size_t default_pipeline_queue_depth = 64;
+
+pipeline_stats multiply_pipeline(std::string_view input, const std::function<void(std::string_view)>& write,
+                                 unsigned int workers, std::size_t queue_depth = default_pipeline_queue_depth);
+
+#endif // __multiply_pipeline_h
@@ -0,0 +1,448 @@
+//
+// MultiplyScheduler.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// class definitions for a size-aware multiply scheduler (using RAII patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_MULTIPLYSCHEDULER_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp MultiplyScheduler.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_MULTIPLYSCHEDULER_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE MultiplyScheduler Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_MULTIPLYSCHEDULER_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "karatsuba.h"
+#include "MultiplyScheduler.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+// a submitted multiply
+struct MultiplyScheduler::job
+{
+    multiply_lane lane;
+    std::promise<IntList> result;
+    std::chrono::steady_clock::time_point submitted = std::chrono::steady_clock::now();
+    std::atomic<bool> started {false};
+    std::atomic<bool> done {false};     // (result set, one way or the other)
+};
+
+// one sub-product of a job: the whole thing, for small and medium jobs and at
+// the root of a large one, and otherwise one of its parent's three
+struct MultiplyScheduler::node
+{
+    std::shared_ptr<job> owner;
+    std::shared_ptr<node> parent;
+    int slot = 0;                       // which of the parent's sub-products this is
+
+    IntList x, y;                       // (released once split)
+
+    unsigned long m = 0;                // the split, and the children's products
+    std::optional<IntList> products[3];
+    std::atomic<int> remaining {3};
+
+    node( std::shared_ptr<job> owner, std::shared_ptr<node> parent, int slot, IntList x, IntList y )
+        : owner( std::move(owner) ), parent( std::move(parent) ), slot( slot ), x( std::move(x) ), y( std::move(y) )
+    {}
+};
+
+
+
+// ===============================================================================
+// class MultiplyScheduler constructors
+// ===============================================================================
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+MultiplyScheduler::MultiplyScheduler( unsigned int threads, multiply_scheduler_options options )
+    : options( options )
+{
+    if ( threads == 0 )
+        throw std::invalid_argument( "a scheduler needs at least one worker" );
+    if ( options.small_max_digits > options.medium_max_digits )
+        throw std::invalid_argument( "small_max_digits (" + std::to_string(options.small_max_digits) +
+                                     ") must be <= medium_max_digits (" +
+                                     std::to_string(options.medium_max_digits) + ")" );
+
+    // (at least one worker always has to be free to take the other lanes)
+    unsigned int reserved = threads > 1 ? std::min( options.reserved_small_workers, threads-1 ) : 0;
+
+    for ( unsigned int i = 0; i < threads; ++i )
+        workers.emplace_back( [this, small_only = i < reserved] { worker_loop( small_only ); } );
+}
+
+MultiplyScheduler::~MultiplyScheduler()
+{
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        stopping = true;
+    }
+    work_ready.notify_all();
+
+    for ( auto& w : workers )
+        w.join();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+// (thresholds scaled down, so the tests' operands cover every lane)
+static multiply_scheduler_options small_sizes()
+{
+    multiply_scheduler_options options;
+    options.small_max_digits  = 64;
+    options.medium_max_digits = 512;
+    options.slice_digits      = 100;
+    return options;
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_scheduler_construction )
+{
+    {   //
+        // shutting down finishes everything already submitted
+        //
+        std::vector<std::future<IntList>> products;
+        {
+            MultiplyScheduler scheduler( 2, small_sizes() );
+            for ( int i=0; i < 10; i++ )
+                products.push_back( scheduler.submit( random_int_list( 700 ), IntList( 1 ) ) );
+        }
+        for ( auto& p : products )
+            BOOST_CHECK( p.wait_for( std::chrono::seconds(0) ) == std::future_status::ready );
+    }
+
+    BOOST_CHECK_THROW( MultiplyScheduler( 0 ), std::invalid_argument );
+    multiply_scheduler_options backwards;
+    backwards.small_max_digits = 1000;
+    backwards.medium_max_digits = 10;
+    BOOST_CHECK_THROW( MultiplyScheduler( 1, backwards ), std::invalid_argument );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class MultiplyScheduler methods
+// ===============================================================================
+
+// *******************************************************************************
+// MultiplyScheduler::lane_for / MultiplyScheduler::submit
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+multiply_lane MultiplyScheduler::lane_for( unsigned long x_digits, unsigned long y_digits ) const
+{
+    auto cost = karatsuba_cost( x_digits, y_digits );
+
+    if ( cost <= karatsuba_cost( options.small_max_digits, options.small_max_digits ) )
+        return multiply_lane::small;
+    if ( cost <= karatsuba_cost( options.medium_max_digits, options.medium_max_digits ) )
+        return multiply_lane::medium;
+    return multiply_lane::large;
+}
+//
+std::future<IntList> MultiplyScheduler::submit( IntList x, IntList y )
+{
+    auto j = std::make_shared<job>();
+    j->lane = lane_for( x.size(), y.size() );
+    auto future = j->result.get_future();
+
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        if ( stopping )
+            throw std::logic_error( "can't submit to a scheduler that's shutting down" );
+        ++outstanding;
+        ++stats[ std::size_t(j->lane) ].submitted;
+    }
+
+    auto root = std::make_shared<node>( j, nullptr, 0, std::move(x), std::move(y) );
+    enqueue( j->lane, [this, root] { expand( root ); } );
+    return future;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_scheduler_submit )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // products from every lane match the plain multiply
+        //
+        MultiplyScheduler scheduler( 3, small_sizes() );
+        BOOST_CHECK( scheduler.lane_for( 10, 64 ) == multiply_lane::small );
+        BOOST_CHECK( scheduler.lane_for( 65, 3 ) == multiply_lane::medium );
+        BOOST_CHECK( scheduler.lane_for( 512, 512 ) == multiply_lane::medium );
+        BOOST_CHECK( scheduler.lane_for( 1, 513 ) == multiply_lane::large );
+
+        std::vector<IntList> xs, ys;
+        std::vector<std::future<IntList>> products;
+        for ( int i=0; i < 60; i++ ) {
+            unsigned long digits = i % 3 == 0 ? 1 + std::rand() % 64
+                                 : i % 3 == 1 ? 65 + std::rand() % 400
+                                              : 513 + std::rand() % 3000;
+            xs.push_back( random_int_list( digits ) );
+            ys.push_back( random_int_list( 1 + std::rand() % digits ) );
+            products.push_back( scheduler.submit( xs.back().clone(), ys.back().clone() ) );
+        }
+        for ( std::size_t i = 0; i < products.size(); ++i )
+            BOOST_CHECK( products[i].get() == karatsuba( xs[i], ys[i] ) );
+
+        for ( auto lane : { multiply_lane::small, multiply_lane::medium, multiply_lane::large } ) {
+            auto s = scheduler.statistics( lane );
+            BOOST_CHECK( s.submitted == 20 );
+            BOOST_CHECK( s.completed == 20 );
+            BOOST_CHECK( s.max_wait_seconds >= 0 );
+        }
+
+        // sparse large operands go through in one piece, and zero is fine
+        IntList sparse( 1 );
+        for ( int i=0; i < 2000; i++ )
+            sparse.push_back( 0 );
+        sparse.push_back( 7 );
+        auto y = random_int_list( 600 );
+        BOOST_CHECK( scheduler.submit( sparse.clone(), y.clone() ).get() == karatsuba( sparse, y ) );
+        BOOST_CHECK( scheduler.submit( IntList(0), random_int_list( 600 ) ).get() == IntList(0) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// MultiplyScheduler::expand / MultiplyScheduler::complete
+// *******************************************************************************
+//
+// A large job's tasks: expanding a node either multiplies it out (once it's
+// down to a slice) or splits it into its three sub-products and queues them;
+// completing one hands its product up to its parent, and the last of three to
+// complete queues the parent's join. Sub-tasks go on the front of the large
+// lane, so one large job runs depth-first (keeping only a recursion's worth of
+// operands around, as the plain recursion would) rather than expanding the
+// whole tree at once.
+//
+// Once anything in a job has failed, the rest of its tasks do nothing.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MultiplyScheduler::expand( std::shared_ptr<node> n )
+{
+    auto& j = *n->owner;
+    if ( j.done )
+        return;
+    started( j );
+
+    try {
+        auto digits = std::max( n->x.size(), n->y.size() );
+
+        //
+        // small and medium jobs, slices, and anything karatsuba multiplies
+        // block by block (its own way) go in one piece
+        //
+        if ( j.lane != multiply_lane::large || digits <= options.slice_digits || digits < 2 ||
+             (!n->parent && karatsuba_goes_sparse( n->x, n->y )) ) {
+            complete( n, karatsuba( n->x, n->y ) );
+            return;
+        }
+
+        auto step = karatsuba_split( n->x, n->y );
+        n->m = step.m;
+        n->x = IntList( 0 );
+        n->y = IntList( 0 );
+
+        std::pair<IntList, IntList>* subs[3] = { &step.s1, &step.s2, &step.s1xs2 };
+        for ( int i = 0; i < 3; ++i ) {
+            auto child = std::make_shared<node>( n->owner, n, i, std::move( subs[i]->first ),
+                                                 std::move( subs[i]->second ) );
+            enqueue( multiply_lane::large, [this, child] { expand( child ); }, true );
+        }
+    }
+    catch (...) {
+        if ( !j.done.exchange( true ) ) {
+            j.result.set_exception( std::current_exception() );
+            finished( j );
+        }
+    }
+}
+//
+void MultiplyScheduler::complete( std::shared_ptr<node> n, IntList product )
+{
+    auto& j = *n->owner;
+
+    if ( !n->parent ) {
+        if ( !j.done.exchange( true ) ) {
+            j.result.set_value( std::move(product) );
+            finished( j );
+        }
+        return;
+    }
+
+    auto parent = n->parent;
+    parent->products[ n->slot ] = std::move(product);
+    if ( --parent->remaining != 0 )
+        return;
+
+    enqueue( multiply_lane::large, [this, parent] {
+        auto& j = *parent->owner;
+        if ( j.done )
+            return;
+        try {
+            auto product = karatsuba_join( *parent->products[0], *parent->products[1], *parent->products[2],
+                                           parent->m );
+            for ( auto& p : parent->products )
+                p.reset();
+            complete( parent, std::move(product) );
+        }
+        catch (...) {
+            if ( !j.done.exchange( true ) ) {
+                j.result.set_exception( std::current_exception() );
+                finished( j );
+            }
+        }
+    }, true );
+}
+
+
+
+// *******************************************************************************
+// MultiplyScheduler::worker_loop / enqueue / started / finished / statistics
+// *******************************************************************************
+//
+// Workers take the first task of the highest-priority lane they serve that has
+// one (so a lower lane only gets a worker when everything above it is empty),
+// and leave once the scheduler is stopping and every submitted job is done.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MultiplyScheduler::worker_loop( bool small_only )
+{
+    const std::size_t lanes_served = small_only ? 1 : multiply_lane_count;
+
+    auto next_lane = [&]() -> std::deque<task>* {
+        for ( std::size_t l = 0; l < lanes_served; ++l )
+            if ( !lanes[l].empty() )
+                return &lanes[l];
+        return nullptr;
+    };
+
+    std::unique_lock<std::mutex> guard( lock );
+    for ( ;; ) {
+        std::deque<task>* lane;
+        work_ready.wait( guard, [&] { return (lane = next_lane()) || (stopping && outstanding == 0); } );
+        if ( !lane )
+            return;
+
+        auto t = std::move( lane->front() );
+        lane->pop_front();
+
+        guard.unlock();
+        t();
+        guard.lock();
+    }
+}
+//
+void MultiplyScheduler::enqueue( multiply_lane lane, task t, bool urgent )
+{
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        auto& q = lanes[ std::size_t(lane) ];
+        if ( urgent )
+            q.push_front( std::move(t) );
+        else
+            q.push_back( std::move(t) );
+    }
+    // (all, since the one that wakes might only serve the small lane)
+    work_ready.notify_all();
+}
+//
+void MultiplyScheduler::started( job& j )
+{
+    if ( j.started.exchange( true ) )
+        return;
+
+    double wait = std::chrono::duration<double>( std::chrono::steady_clock::now() - j.submitted ).count();
+    std::lock_guard<std::mutex> guard( lock );
+    auto& s = stats[ std::size_t(j.lane) ];
+    s.total_wait_seconds += wait;
+    s.max_wait_seconds = std::max( s.max_wait_seconds, wait );
+}
+//
+void MultiplyScheduler::finished( job& j )
+{
+    bool last;
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        ++stats[ std::size_t(j.lane) ].completed;
+        last = --outstanding == 0 && stopping;
+    }
+    if ( last )
+        work_ready.notify_all();
+}
+//
+MultiplyScheduler::lane_statistics MultiplyScheduler::statistics( multiply_lane lane )
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return stats[ std::size_t(lane) ];
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_scheduler_slices )
+{
+    {   //
+        // with only one worker, small jobs submitted behind a large one still
+        // finish long before it does, at its next slice boundary
+        //
+        MultiplyScheduler scheduler( 1, small_sizes() );
+        auto large = scheduler.submit( random_int_list( 30000 ), random_int_list( 30000 ) );
+
+        std::vector<std::future<IntList>> smalls;
+        for ( int i=0; i < 50; i++ )
+            smalls.push_back( scheduler.submit( IntList( 12 ), IntList( i ) ) );
+        for ( int i=0; i < 50; i++ )
+            BOOST_CHECK( smalls[i].get() == IntList( 12 * i ) );
+
+        BOOST_CHECK( large.wait_for( std::chrono::seconds(0) ) != std::future_status::ready );
+        BOOST_CHECK( large.get().size() >= 59999 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
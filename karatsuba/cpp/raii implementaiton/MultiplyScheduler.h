@@ -0,0 +1,99 @@
+//
+// MultiplyScheduler.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class declaration for a size-aware multiply scheduler (using RAII patterns):
+// queued multiplies are sorted into lanes by estimated cost, so that small
+// ones never wait long behind big ones.
+//
+#ifndef __multiply_scheduler_h
+#define __multiply_scheduler_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "IntList.h"
+
+// lanes, in the order workers serve them
+enum class multiply_lane { small = 0, medium = 1, large = 2 };
+const std::size_t multiply_lane_count = 3;
+
+// a job's lane is picked from the longer operand's length (by way of its
+// karatsuba_cost); large jobs are cut into sub-products of at most
+// 'slice_digits' each before they're run
+struct multiply_scheduler_options
+{
+    unsigned long small_max_digits  = 2048;
+    unsigned long medium_max_digits = 65536;
+    unsigned long slice_digits      = 8192;
+    unsigned int  reserved_small_workers = 1;   // (only when there's more than one worker)
+};
+
+class MultiplyScheduler
+//
+// A set of worker threads taking tasks from three lanes in strict priority
+// order: small, then medium, then large. Small and medium jobs are each one
+// task. A large job becomes a tree of tasks following its Karatsuba recursion,
+// split down to slices and joined back up, so a worker busy with one comes
+// back to check the higher lanes at every slice; and when there's more than
+// one worker, some are kept for the small lane alone, so small jobs don't even
+// wait out a slice.
+//
+{
+public:
+    struct lane_statistics
+    {
+        unsigned long submitted = 0;
+        unsigned long completed = 0;
+        double total_wait_seconds = 0;  // submission to first task starting, summed
+        double max_wait_seconds = 0;
+    };
+
+private:
+    struct job;
+    struct node;
+    using task = std::function<void()>;
+
+    multiply_scheduler_options options;
+
+    std::mutex lock;
+    std::condition_variable work_ready;
+    std::deque<task> lanes[multiply_lane_count];
+    lane_statistics stats[multiply_lane_count];
+    unsigned long outstanding = 0;      // jobs submitted but not yet finished
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void worker_loop( bool small_only );
+    void enqueue( multiply_lane lane, task t, bool urgent = false );
+    void started( job& j );
+    void finished( job& j );
+
+    // (the large-job tree)
+    void expand( std::shared_ptr<node> n );
+    void complete( std::shared_ptr<node> n, IntList product );
+
+public:
+    // constructors
+    explicit MultiplyScheduler( unsigned int threads, multiply_scheduler_options options = {} );
+    ~MultiplyScheduler();       // (finishes every job already submitted first)
+
+    // copy & move semantics (the workers hold 'this', so neither)
+    MultiplyScheduler( const MultiplyScheduler& ) = delete;
+    MultiplyScheduler& operator=( const MultiplyScheduler& ) = delete;
+
+    // queue x*y; the future gets the product (or whatever the multiply threw)
+    std::future<IntList> submit( IntList x, IntList y );
+
+    multiply_lane lane_for( unsigned long x_digits, unsigned long y_digits ) const;
+    lane_statistics statistics( multiply_lane lane );
+};
+
+#endif // __multiply_scheduler_h
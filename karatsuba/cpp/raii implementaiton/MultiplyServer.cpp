@@ -0,0 +1,1040 @@
+//
+// MultiplyServer.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// class definitions for a local multiplication server and its client (using
+// RAII patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_MULTIPLYSERVER_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp IntListIO.cpp karatsuba.cpp MultiplyServer.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_MULTIPLYSERVER_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE MultiplyServer Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_MULTIPLYSERVER_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "IntListIO.h"
+#include "karatsuba.h"
+#include "MultiplyServer.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// ===============================================================================
+// frames
+// ===============================================================================
+
+namespace {
+
+// little-endian field access, whatever the host byte order
+template<typename T>
+void store_le( char* p, T v )
+{
+    for ( std::size_t i = 0; i < sizeof(T); ++i, v >>= 8 )
+        p[i] = char( v & 0xFF );
+}
+template<typename T>
+T load_le( const char* p )
+{
+    T v = 0;
+    for ( std::size_t i = sizeof(T); i-- > 0; )
+        v = (v << 8) | T( static_cast<unsigned char>(p[i]) );
+    return v;
+}
+
+std::system_error socket_error( const std::string& what )
+{
+    return std::system_error( errno, std::generic_category(), what );
+}
+
+// how long run(), once stopped, waits for replies to go out before it hangs
+// up on the clients that aren't taking them
+const auto stop_grace_period = std::chrono::seconds( 2 );
+
+struct frame
+{
+    std::uint32_t tag;
+    multiply_message kind;
+    std::vector<char> body;
+};
+
+// a frame with its header filled in and room for 'body_size' bytes of body
+// (from multiply_frame_header_size on)
+std::vector<char> make_frame( std::uint32_t tag, multiply_message kind, std::size_t body_size )
+{
+    const std::size_t rest = multiply_frame_header_size - 4 + body_size;
+    if ( rest > UINT32_MAX )
+        throw std::length_error( "a " + std::to_string(body_size) + "-byte message won't fit in a frame" );
+
+    std::vector<char> f( multiply_frame_header_size + body_size );
+    store_le<std::uint32_t>( f.data(), rest );
+    store_le<std::uint32_t>( f.data() + 4, tag );
+    f[8] = char( kind );
+    return f;
+}
+
+std::vector<char> int_list_frame( std::uint32_t tag, multiply_message kind, std::initializer_list<const IntList*> ils )
+{
+    std::size_t size = 0;
+    for ( auto il : ils )
+        size += serialized_size( *il );
+
+    auto f = make_frame( tag, kind, size );
+    std::size_t at = multiply_frame_header_size;
+    for ( auto il : ils )
+        at += serialize( *il, std::span<char>( f ).subspan( at ) );
+    return f;
+}
+
+std::vector<char> error_frame( std::uint32_t tag, std::string_view what )
+{
+    auto f = make_frame( tag, multiply_message::error, what.size() );
+    std::memcpy( f.data() + multiply_frame_header_size, what.data(), what.size() );
+    return f;
+}
+
+void send_all( int fd, std::span<const char> bytes )
+{
+    while ( !bytes.empty() ) {
+        auto n = ::send( fd, bytes.data(), bytes.size(), MSG_NOSIGNAL );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 )
+            throw socket_error( "can't send" );
+        bytes = bytes.subspan( n );
+    }
+}
+
+// false if the other end hung up before the first byte
+bool receive_all( int fd, std::span<char> bytes )
+{
+    for ( std::size_t got = 0; got < bytes.size(); ) {
+        auto n = ::recv( fd, bytes.data() + got, bytes.size() - got, 0 );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 )
+            throw socket_error( "can't receive" );
+        if ( n == 0 ) {
+            if ( got == 0 )
+                return false;
+            throw std::runtime_error( "connection closed in the middle of a frame" );
+        }
+        got += n;
+    }
+    return true;
+}
+
+// the next frame, or nothing if the other end hung up cleanly between frames
+std::optional<frame> receive_frame( int fd, std::size_t max_frame_bytes )
+{
+    char header[multiply_frame_header_size];
+    if ( !receive_all( fd, { header, 4 } ) )
+        return std::nullopt;
+
+    auto rest = load_le<std::uint32_t>( header );
+    if ( rest < multiply_frame_header_size - 4 || rest > max_frame_bytes )
+        throw std::runtime_error( "bad frame length " + std::to_string(rest) );
+
+    if ( !receive_all( fd, { header + 4, multiply_frame_header_size - 4 } ) )
+        throw std::runtime_error( "connection closed in the middle of a frame" );
+
+    frame f { load_le<std::uint32_t>( header + 4 ), multiply_message( header[8] ),
+              std::vector<char>( rest - (multiply_frame_header_size - 4) ) };
+    if ( !f.body.empty() && !receive_all( fd, f.body ) )
+        throw std::runtime_error( "connection closed in the middle of a frame" );
+    return f;
+}
+
+sockaddr_un socket_address( const std::filesystem::path& path )
+{
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if ( path.native().size() >= sizeof(addr.sun_path) )
+        throw std::invalid_argument( "socket path " + path.string() + " is too long" );
+    std::strcpy( addr.sun_path, path.c_str() );
+    return addr;
+}
+
+// whether a server is listening on the socket file at addr: a connect that's
+// refused means the file was just left behind by one that didn't get to
+// clean up (anything else, and we can't tell, so say so)
+bool socket_in_use( const sockaddr_un& addr )
+{
+    int probe = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( probe < 0 )
+        throw socket_error( "can't create socket" );
+
+    int result = ::connect( probe, reinterpret_cast<const sockaddr*>( &addr ), sizeof(addr) );
+    int error = errno;
+    ::close( probe );
+
+    if ( result == 0 )
+        return true;
+    if ( error == ECONNREFUSED )
+        return false;
+    errno = error;
+    throw socket_error( "can't tell whether " + std::string( addr.sun_path ) + " is in use" );
+}
+
+}
+
+
+
+// ===============================================================================
+// class MultiplyServer connections
+// ===============================================================================
+//
+// A connection is shared between its reader thread, its writer thread, and
+// every request of its that's still queued, so the socket stays open until
+// the last response to it has gone out. Replies (from the batches' tasks, or
+// error replies from the reader) only ever get added to its outbox, which never
+// blocks; the writer thread does the sending. The writer finishes once the
+// reader has stopped and every request it queued has been answered.
+//
+struct MultiplyServer::connection
+{
+    int fd;
+    std::size_t max_backlog;
+    std::atomic<bool> done {false};         // the writer has nothing more to do
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::vector<char>> outbox;
+    std::size_t backlog = 0;                // bytes in the outbox, or being sent
+    unsigned long outstanding = 0;          // requests queued, but not answered
+    bool reading = true;
+    bool broken = false;                    // hung up on; replies just get dropped
+
+    std::condition_variable finished;       // (done, for run() shutting down)
+
+    connection( int fd, std::size_t max_backlog ) : fd( fd ), max_backlog( max_backlog ) {}
+    ~connection() { ::close( fd ); }
+
+    // (the reader, before queuing a request)
+    void expect_reply()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        ++outstanding;
+    }
+
+    // queue a frame for the writer; 'answers' if it's the reply to a request
+    // counted by expect_reply. A client that's gone away, or has stopped
+    // reading, just doesn't get its answer. Returns false if the connection
+    // was hung up on because of this one.
+    bool reply( std::vector<char> f, bool answers = false )
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        if ( answers )
+            --outstanding;
+        wake.notify_one();
+        if ( broken )
+            return true;
+
+        if ( backlog > 0 && backlog + f.size() > max_backlog ) {
+            hang_up();
+            return false;
+        }
+        backlog += f.size();
+        outbox.push_back( std::move(f) );
+        return true;
+    }
+
+    // (the reader, once it's stopped)
+    void finish_reading()
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        reading = false;
+        wake.notify_one();
+    }
+
+    // (the writer thread) send replies as they come, until there can't be
+    // any more
+    void write_replies()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        for ( ;; ) {
+            wake.wait( guard, [this]{ return !outbox.empty() || (!reading && outstanding == 0); } );
+            if ( outbox.empty() )
+                break;
+
+            auto f = std::move( outbox.front() );
+            outbox.pop_front();
+            guard.unlock();
+            bool sent = true;
+            try {
+                send_all( fd, f );
+            }
+            catch ( const std::system_error& ) {
+                sent = false;
+            }
+            guard.lock();
+
+            if ( broken )
+                continue;
+            backlog -= f.size();
+            if ( !sent )
+                hang_up();
+        }
+        ::shutdown( fd, SHUT_RDWR );
+        done = true;
+        finished.notify_all();
+    }
+
+    // (run(), shutting down) give the writer until 'deadline' to send what's
+    // left, then hang up: a client that has stopped reading would otherwise
+    // keep it blocked in send for good. Returns false if it was hung up on.
+    bool finish_writing( std::chrono::steady_clock::time_point deadline )
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        if ( finished.wait_until( guard, deadline, [this]{ return done.load(); } ) || broken )
+            return true;
+        hang_up();
+        return false;
+    }
+
+private:
+    // (with lock held) drop what's waiting, and wake the reader (and a
+    // writer stuck on a full socket) up with an error
+    void hang_up()
+    {
+        broken = true;
+        outbox.clear();
+        backlog = 0;
+        ::shutdown( fd, SHUT_RDWR );
+    }
+};
+
+struct MultiplyServer::pending
+{
+    std::shared_ptr<connection> conn;
+    std::uint32_t tag;
+    IntList x, y;
+};
+
+
+
+// ===============================================================================
+// class MultiplyServer constructors
+// ===============================================================================
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+MultiplyServer::MultiplyServer( const std::filesystem::path& socket_path, WorkStealingPool& pool,
+                                std::size_t max_batch, std::size_t max_frame_bytes, std::size_t max_backlog_bytes )
+    : socket_path( socket_path ), pool( pool ), max_batch( max_batch ), max_frame_bytes( max_frame_bytes ),
+      max_backlog_bytes( max_backlog_bytes )
+{
+    if ( max_batch == 0 )
+        throw std::invalid_argument( "max_batch must be > 0" );
+
+    auto addr = socket_address( socket_path );
+
+    // a socket left behind by a server that didn't get to clean up can go;
+    // one that a server is still listening on can't
+    if ( std::filesystem::is_socket( socket_path ) ) {
+        if ( socket_in_use( addr ) )
+            throw std::system_error( EADDRINUSE, std::generic_category(),
+                                     "a server is already listening on " + socket_path.string() );
+        std::filesystem::remove( socket_path );
+    }
+
+    listen_fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( listen_fd < 0 )
+        throw socket_error( "can't create socket" );
+
+    if ( ::bind( listen_fd, reinterpret_cast<sockaddr*>( &addr ), sizeof(addr) ) != 0 ||
+         ::listen( listen_fd, SOMAXCONN ) != 0 ||
+         ::pipe2( wake_fds, O_CLOEXEC | O_NONBLOCK ) != 0 ) {
+        auto error = socket_error( "can't listen on " + socket_path.string() );
+        ::close( listen_fd );
+        throw error;
+    }
+}
+
+MultiplyServer::~MultiplyServer()
+{
+    ::close( listen_fd );
+    ::close( wake_fds[0] );
+    ::close( wake_fds[1] );
+    std::error_code ignored;
+    std::filesystem::remove( socket_path, ignored );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+// a server on a socket of its own, running on a thread of its own for as long
+// as a test needs it
+struct test_server
+{
+    std::filesystem::path path;
+    WorkStealingPool pool;
+    MultiplyServer server;
+    std::thread thread;
+
+    explicit test_server( const std::string& name, std::size_t max_backlog_bytes = default_max_reply_backlog_bytes )
+        : path( std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid())) ),
+          pool( 2 ), server( path, pool, 8, default_max_frame_bytes, max_backlog_bytes ),
+          thread( [this] { server.run(); } )
+    {}
+
+    ~test_server()
+    {
+        if ( thread.joinable() ) {
+            server.stop();
+            thread.join();
+        }
+    }
+
+    int connect_raw() const
+    {
+        int raw = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+        auto addr = socket_address( path );
+        BOOST_REQUIRE( ::connect( raw, reinterpret_cast<sockaddr*>( &addr ), sizeof(addr) ) == 0 );
+        return raw;
+    }
+};
+
+BOOST_AUTO_TEST_CASE( test_multiply_server_construction )
+{
+    {   //
+        // a server comes up listening, and goes away taking its socket with it
+        //
+        std::filesystem::path path;
+        {
+            test_server serving( "multiply_server_construction_test" );
+            path = serving.path;
+            BOOST_CHECK( std::filesystem::is_socket( path ) );
+        }
+        BOOST_CHECK( !std::filesystem::exists( path ) );
+    }
+
+    {   //
+        // a socket file nobody's listening on is taken over; one that a server
+        // is listening on is left alone, server and all
+        //
+        test_server serving( "multiply_server_in_use_test" );
+        WorkStealingPool pool( 1 );
+        BOOST_CHECK_THROW( MultiplyServer( serving.path, pool ), std::system_error );
+        BOOST_CHECK( std::filesystem::is_socket( serving.path ) );
+        BOOST_CHECK( MultiplyClient( serving.path ).multiply( IntList(6), IntList(7) ) == IntList(42) );
+
+        auto stale = std::filesystem::temp_directory_path() /
+                     ("multiply_server_stale_test_" + std::to_string(::getpid()));
+        {
+            int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+            auto addr = socket_address( stale );
+            BOOST_REQUIRE( ::bind( fd, reinterpret_cast<sockaddr*>( &addr ), sizeof(addr) ) == 0 );
+            ::close( fd );      // (and the file stays behind)
+        }
+        BOOST_REQUIRE( std::filesystem::is_socket( stale ) );
+        {
+            MultiplyServer server( stale, pool );
+            BOOST_CHECK( std::filesystem::is_socket( stale ) );
+        }
+        BOOST_CHECK( !std::filesystem::exists( stale ) );
+    }
+
+    WorkStealingPool pool( 1 );
+    BOOST_CHECK_THROW( MultiplyServer( "/no/such/directory/socket" ), std::system_error );
+    BOOST_CHECK_THROW( MultiplyServer( "socket", pool, 0 ), std::invalid_argument );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class MultiplyServer methods
+// ===============================================================================
+
+// *******************************************************************************
+// MultiplyServer::run / MultiplyServer::stop
+// *******************************************************************************
+//
+// The calling thread accepts connections (and reaps the reader and writer
+// threads of ones that are finished) until stop() pokes the wake pipe.
+// Shutting down goes in stages so nothing that was asked for gets lost: stop
+// reading, let the readers finish, close the queue, let the dispatcher answer
+// what's in it, and let the writers send those answers (for as long as their
+// clients take them, up to stop_grace_period). If waiting for connections
+// fails, it shuts down the same way and then throws.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MultiplyServer::run()
+{
+    std::lock_guard<std::mutex> once( run_lock );
+
+    BoundedQueue<pending> queue( 4*max_batch );
+    std::thread dispatcher( [&] { dispatch( queue ); } );
+
+    struct client { std::shared_ptr<connection> conn; std::thread reader, writer; };
+    std::vector<client> clients;
+
+    auto reap = [&] {
+        std::erase_if( clients, []( client& c ) {
+            if ( !c.conn->done )
+                return false;
+            c.reader.join();
+            c.writer.join();
+            return true;
+        } );
+    };
+
+    std::optional<std::system_error> failure;
+    for ( ;; ) {
+        pollfd fds[2] = { { listen_fd, POLLIN, 0 }, { wake_fds[0], POLLIN, 0 } };
+        if ( ::poll( fds, 2, 1000 ) < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            failure = socket_error( "can't wait for connections" );
+            break;
+        }
+        if ( fds[1].revents ) {
+            // drain the wake-up, so the server can run() again
+            char byte;
+            while ( ::read( wake_fds[0], &byte, 1 ) < 0 && errno == EINTR )
+                ;
+            break;
+        }
+
+        reap();
+
+        if ( fds[0].revents & POLLIN ) {
+            int fd = ::accept4( listen_fd, nullptr, nullptr, SOCK_CLOEXEC );
+            if ( fd < 0 )
+                continue;
+            ++stats.connections;
+
+            auto conn = std::make_shared<connection>( fd, max_backlog_bytes );
+            clients.push_back( { conn, std::thread( [this, conn, &queue] { read_requests( conn, queue ); } ),
+                                       std::thread( [conn] { conn->write_replies(); } ) } );
+        }
+    }
+
+    for ( auto& c : clients )
+        ::shutdown( c.conn->fd, SHUT_RD );
+    for ( auto& c : clients )
+        c.reader.join();
+
+    queue.close();
+    dispatcher.join();
+
+    const auto deadline = std::chrono::steady_clock::now() + stop_grace_period;
+    for ( auto& c : clients ) {
+        if ( !c.conn->finish_writing( deadline ) )
+            ++stats.dropped;
+        c.writer.join();
+    }
+
+    if ( failure )
+        throw *failure;
+}
+//
+void MultiplyServer::stop()
+{
+    char byte = 1;
+    while ( ::write( wake_fds[1], &byte, 1 ) < 0 && errno == EINTR )
+        ;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_server_run )
+{
+    std::srand(time(nullptr));
+
+    test_server serving( "multiply_server_run_test" );
+
+    {   //
+        // several clients at once, each checking its own products (collected,
+        // since the checks can't be made from the client threads)
+        //
+        const int clients = 4, requests = 50;
+        std::vector<std::vector<IntList>> xs( clients ), ys( clients ), products( clients );
+        for ( int c = 0; c < clients; ++c )
+            for ( int r = 0; r < requests; ++r ) {
+                xs[c].push_back( random_int_list( 1 + std::rand() % 600 ) );
+                ys[c].push_back( random_int_list( 1 + std::rand() % 600 ) );
+            }
+
+        std::vector<std::thread> threads;
+        for ( int c = 0; c < clients; ++c )
+            threads.emplace_back( [&, c] {
+                MultiplyClient client( serving.path );
+                for ( int r = 0; r < requests; ++r )
+                    products[c].push_back( client.multiply( xs[c][r], ys[c][r] ) );
+            } );
+        for ( auto& t : threads )
+            t.join();
+
+        for ( int c = 0; c < clients; ++c ) {
+            BOOST_REQUIRE( products[c].size() == std::size_t(requests) );
+            for ( int r = 0; r < requests; ++r )
+                BOOST_CHECK( products[c][r] == karatsuba( xs[c][r], ys[c][r] ) );
+        }
+
+        BOOST_CHECK( serving.server.statistics().connections == std::size_t(clients) );
+        BOOST_CHECK( serving.server.statistics().requests == std::size_t(clients*requests) );
+        BOOST_CHECK( serving.server.statistics().batches <= std::size_t(clients*requests) );
+        BOOST_CHECK( serving.server.statistics().batches > 0 );
+    }
+
+    {   //
+        // stopping doesn't wait forever on a client that never reads its
+        // replies (enough of them to fill the socket, so the writer blocks)
+        //
+        test_server stopping( "multiply_server_stop_test" );
+        int stalled = stopping.connect_raw();
+        IntList x( std::string( 2000, '9' ) );
+        auto request = int_list_frame( 1, multiply_message::multiply, { &x, &x } );
+        for ( int i = 0; i < 500; ++i )
+            send_all( stalled, request );
+
+        // (wait for them all to be answered, and the writer to get stuck)
+        for ( int wait = 0; wait < 1000 && stopping.server.statistics().requests < 500; ++wait )
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        std::this_thread::sleep_for( std::chrono::milliseconds(100) );
+
+        auto started = std::chrono::steady_clock::now();
+        stopping.server.stop();
+        stopping.thread.join();
+        BOOST_CHECK( std::chrono::steady_clock::now() - started < 10*stop_grace_period );
+        BOOST_CHECK( stopping.server.statistics().dropped == 1 );
+        ::close( stalled );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// MultiplyServer::read_requests
+// *******************************************************************************
+//
+// (one connection's reader thread) A request that doesn't parse, for whatever
+// reason, gets an error back and the connection carries on; a frame that
+// doesn't, can't, so the connection gets an error with tag 0 and is hung up
+// on once it's been sent.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MultiplyServer::read_requests( const std::shared_ptr<connection>& conn, BoundedQueue<pending>& queue )
+{
+    try {
+        while ( auto f = receive_frame( conn->fd, max_frame_bytes ) ) {
+            std::optional<pending> request;
+            try {
+                if ( f->kind != multiply_message::multiply )
+                    throw std::invalid_argument( "expected a multiply request" );
+
+                std::span<const char> body( f->body );
+                auto x = deserialize( body );
+                auto y = deserialize( body.subspan( serialized_size( x ) ) );
+                request.emplace( pending{ conn, f->tag, std::move(x), std::move(y) } );
+            }
+            catch ( const std::exception& e ) {
+                ++stats.errors;
+                conn->reply( error_frame( f->tag, e.what() ) );
+                continue;
+            }
+
+            ++stats.requests;
+            conn->expect_reply();
+            if ( !queue.push( std::move(*request) ) ) {
+                conn->reply( error_frame( f->tag, "server is stopping" ), true );
+                break;
+            }
+        }
+    }
+    catch ( const std::exception& e ) {
+        ++stats.errors;
+        conn->reply( error_frame( 0, e.what() ) );
+    }
+    conn->finish_reading();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_server_read_requests )
+{
+    test_server serving( "multiply_server_read_test" );
+
+    {   //
+        // a bad request gets an error and the connection lives on; a bad frame
+        // gets the connection closed
+        //
+        MultiplyClient client( serving.path );
+        BOOST_CHECK( client.multiply( IntList(12), IntList(34) ) == IntList(408) );
+
+        int raw = serving.connect_raw();
+
+        auto garbage = make_frame( 7, multiply_message::multiply, 40 );
+        send_all( raw, garbage );
+        auto reply = receive_frame( raw, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 7 );
+        BOOST_CHECK( reply->kind == multiply_message::error );
+
+        IntList a( 5 );
+        send_all( raw, int_list_frame( 8, multiply_message::multiply, { &a, &a } ) );
+        reply = receive_frame( raw, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 8 && reply->kind == multiply_message::product );
+        BOOST_CHECK( deserialize( reply->body ) == IntList(25) );
+
+        char huge[4];
+        store_le<std::uint32_t>( huge, UINT32_MAX );
+        send_all( raw, { huge, 4 } );
+        reply = receive_frame( raw, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 0 && reply->kind == multiply_message::error );
+        BOOST_CHECK( !receive_frame( raw, default_max_frame_bytes ) );
+        ::close( raw );
+
+        BOOST_CHECK( client.multiply( IntList(11), IntList(11) ) == IntList(121) );
+    }
+
+    {   //
+        // a request that fails to parse in any way (here: a digit count far
+        // too big for its buffer) is just an error reply
+        //
+        int raw = serving.connect_raw();
+        IntList a( 5 );
+        auto f = int_list_frame( 3, multiply_message::multiply, { &a, &a } );
+        store_le<std::uint64_t>( f.data() + multiply_frame_header_size + 16, UINT64_MAX );
+        send_all( raw, f );
+        auto reply = receive_frame( raw, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 3 && reply->kind == multiply_message::error );
+
+        send_all( raw, int_list_frame( 4, multiply_message::multiply, { &a, &a } ) );
+        reply = receive_frame( raw, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 4 && reply->kind == multiply_message::product );
+        ::close( raw );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// MultiplyServer::dispatch
+// *******************************************************************************
+//
+// (the dispatcher thread) Waits for one request, then sweeps up whatever else
+// is already queued behind it, so under load the pool gets big batches to
+// spread over its workers and when it's quiet a lone request goes straight
+// through. Batches are forked onto the pool and answer for themselves, so the
+// dispatcher goes straight back to the queue, with up to one batch per worker
+// (and one more) in flight; a request with an operand longer than
+// server_solo_request_digits goes out as a batch of its own, so the small
+// ones swept up with it don't wait on it either.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void MultiplyServer::dispatch( BoundedQueue<pending>& queue )
+{
+    std::mutex lock;
+    std::condition_variable finished;
+    std::size_t in_flight = 0;
+    const std::size_t max_in_flight = pool.size() + 1;
+
+    // multiply a batch and hand each reply over (the connections' writers do
+    // the sending)
+    auto answer = [this]( std::vector<pending>& batch ) {
+        std::vector<std::vector<char>> replies;
+        try {
+            std::vector<std::pair<const IntList*, const IntList*>> pairs;
+            for ( auto& p : batch )
+                pairs.emplace_back( &p.x, &p.y );
+            std::vector<IntList> products;
+            products.reserve( batch.size() );
+            for ( std::size_t i = 0; i < batch.size(); ++i )
+                products.emplace_back( 0 );
+
+            multiply_batch( pairs, products, pool );
+            ++stats.batches;
+            for ( std::size_t i = 0; i < batch.size(); ++i )
+                replies.push_back( int_list_frame( batch[i].tag, multiply_message::product, { &products[i] } ) );
+        }
+        catch ( const std::exception& e ) {
+            replies.clear();
+            for ( auto& p : batch )
+                replies.push_back( error_frame( p.tag, e.what() ) );
+        }
+
+        for ( std::size_t i = 0; i < batch.size(); ++i )
+            if ( !batch[i].conn->reply( std::move( replies[i] ), true ) )
+                ++stats.dropped;
+    };
+
+    auto launch = [&]( std::vector<pending> requests ) {
+        {
+            std::unique_lock<std::mutex> guard( lock );
+            finished.wait( guard, [&]{ return in_flight < max_in_flight; } );
+            ++in_flight;
+        }
+
+        auto batch = std::make_shared<std::vector<pending>>( std::move(requests) );
+        auto done = [&] {
+            std::lock_guard<std::mutex> guard( lock );
+            --in_flight;
+            finished.notify_all();
+        };
+        try {
+            pool.fork( [batch, answer, done] {
+                try {
+                    answer( *batch );
+                }
+                catch (...) {
+                    done();
+                    throw;
+                }
+                done();
+            } );
+        }
+        catch ( const std::exception& ) {
+            // (couldn't fork it, so answer it here)
+            answer( *batch );
+            done();
+        }
+    };
+
+    auto solo = []( const pending& p ) {
+        return std::max( p.x.size(), p.y.size() ) > server_solo_request_digits;
+    };
+
+    while ( auto first = queue.pop() ) {
+        std::vector<pending> batch;
+        for ( auto next = std::move(first); next; next = queue.try_pop() ) {
+            if ( solo( *next ) ) {
+                std::vector<pending> alone;
+                alone.push_back( std::move(*next) );
+                launch( std::move(alone) );
+            }
+            else
+                batch.push_back( std::move(*next) );
+            if ( batch.size() == max_batch )
+                break;
+        }
+        if ( !batch.empty() )
+            launch( std::move(batch) );
+    }
+
+    // (the batches still refer to our locals)
+    std::unique_lock<std::mutex> guard( lock );
+    finished.wait( guard, [&]{ return in_flight == 0; } );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_server_dispatch )
+{
+    test_server serving( "multiply_server_dispatch_test", 256*1024 );
+
+    {   //
+        // a client that sends lots but never reads its replies doesn't hold
+        // anybody else up, and gets hung up on once too much has piled up
+        //
+        int stalled = serving.connect_raw();
+        IntList x( std::string( 2000, '9' ) );
+        auto request = int_list_frame( 1, multiply_message::multiply, { &x, &x } );
+        try {
+            for ( int i = 0; i < 1000; ++i )
+                send_all( stalled, request );
+        }
+        catch ( const std::system_error& ) {}   // (it may be hung up on before it's done)
+
+        MultiplyClient client( serving.path );
+        BOOST_CHECK( client.multiply( IntList(6), IntList(7) ) == IntList(42) );
+
+        // (the last of its requests may still be getting multiplied)
+        for ( int wait = 0; wait < 1000 && serving.server.statistics().dropped == 0; ++wait )
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        BOOST_CHECK( serving.server.statistics().dropped == 1 );
+
+        unsigned int replies = 0;
+        try {
+            while ( receive_frame( stalled, default_max_frame_bytes ) )
+                ++replies;
+        }
+        catch ( const std::exception& ) {}      // (cut off mid-frame)
+        BOOST_CHECK( replies < 1000 );
+        ::close( stalled );
+
+        BOOST_CHECK( client.multiply( IntList(11), IntList(11) ) == IntList(121) );
+    }
+
+    {   //
+        // a big request doesn't hold up the small ones that come in after it
+        //
+        const auto read_so_far = serving.server.statistics().requests.load();
+        int big = serving.connect_raw();
+        auto x = random_int_list( 200000 );
+        send_all( big, int_list_frame( 1, multiply_message::multiply, { &x, &x } ) );
+        for ( int wait = 0; wait < 1000 && serving.server.statistics().requests == read_so_far; ++wait )
+            std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+
+        MultiplyClient client( serving.path );
+        BOOST_CHECK( client.multiply( IntList(6), IntList(7) ) == IntList(42) );
+        pollfd still_going { big, POLLIN, 0 };
+        BOOST_CHECK( ::poll( &still_going, 1, 0 ) == 0 );
+
+        auto reply = receive_frame( big, default_max_frame_bytes );
+        BOOST_REQUIRE( reply );
+        BOOST_CHECK( reply->tag == 1 && reply->kind == multiply_message::product );
+        auto product = deserialize( reply->body );
+        BOOST_CHECK( product.size() == 400000 || product.size() == 399999 );
+        ::close( big );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class MultiplyClient
+// ===============================================================================
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+MultiplyClient::MultiplyClient( const std::filesystem::path& socket_path, std::size_t max_frame_bytes )
+    : max_frame_bytes( max_frame_bytes )
+{
+    auto addr = socket_address( socket_path );
+
+    fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( fd < 0 )
+        throw socket_error( "can't create socket" );
+    if ( ::connect( fd, reinterpret_cast<sockaddr*>( &addr ), sizeof(addr) ) != 0 ) {
+        auto error = socket_error( "can't connect to " + socket_path.string() );
+        ::close( fd );
+        throw error;
+    }
+}
+
+MultiplyClient::~MultiplyClient()
+{
+    if ( fd >= 0 )
+        ::close( fd );
+}
+
+MultiplyClient::MultiplyClient( MultiplyClient&& that )
+    : fd( std::exchange( that.fd, -1 ) ), next_tag( that.next_tag ), max_frame_bytes( that.max_frame_bytes )
+{}
+
+MultiplyClient& MultiplyClient::operator=( MultiplyClient&& that )
+{
+    if ( this != &that ) {
+        if ( fd >= 0 )
+            ::close( fd );
+        fd = std::exchange( that.fd, -1 );
+        next_tag = that.next_tag;
+        max_frame_bytes = that.max_frame_bytes;
+    }
+    return *this;
+}
+
+IntList MultiplyClient::multiply( const IntList& x, const IntList& y )
+{
+    if ( fd < 0 )
+        throw std::logic_error( "client has been moved from" );
+
+    const auto tag = next_tag++;
+    send_all( fd, int_list_frame( tag, multiply_message::multiply, { &x, &y } ) );
+
+    auto f = receive_frame( fd, max_frame_bytes );
+    if ( !f )
+        throw std::runtime_error( "server hung up" );
+
+    if ( f->kind == multiply_message::error )
+        throw std::runtime_error( "server: " + std::string( f->body.begin(), f->body.end() ) );
+    if ( f->kind != multiply_message::product || f->tag != tag )
+        throw std::runtime_error( "unexpected response from server" );
+
+    return deserialize( f->body );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_multiply_client )
+{
+    test_server serving( "multiply_client_test" );
+
+    {   //
+        // a client's requests are answered in turn, and it can be moved
+        //
+        MultiplyClient client( serving.path );
+        BOOST_CHECK( client.multiply( IntList(12), IntList(34) ) == IntList(408) );
+
+        MultiplyClient moved( std::move(client) );
+        BOOST_CHECK( moved.multiply( IntList(11), IntList(11) ) == IntList(121) );
+        BOOST_CHECK_THROW( client.multiply( IntList(1), IntList(1) ), std::logic_error );
+    }
+
+    BOOST_CHECK_THROW( MultiplyClient( "/no/such/directory/socket" ), std::system_error );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
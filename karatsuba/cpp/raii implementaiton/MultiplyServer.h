@@ -0,0 +1,164 @@
+//
+// MultiplyServer.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class declarations for a local multiplication server and its client (using
+// RAII patterns): processes on the same host send operand pairs over a Unix
+// domain socket, and one long-running server batches them onto a shared
+// thread pool and sends the products back.
+//
+#ifndef __multiply_server_h
+#define __multiply_server_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "IntList.h"
+#include "BoundedQueue.h"
+#include "WorkStealingPool.h"
+
+
+
+// ===============================================================================
+// wire protocol
+// ===============================================================================
+//
+// Every message, either way, is one frame (all fields little-endian):
+//
+//     offset  size  field
+//          0     4  length of the rest of the frame (from offset 4 on)
+//          4     4  tag, picked by the client and echoed back in the response
+//          8     1  kind (multiply_message)
+//          9     3  reserved, 0
+//         12     -  body
+//
+//     kind       body
+//     multiply   x then y, each in the binary integer list format (IntListIO.h)
+//     product    the product, in the same format
+//     error      what went wrong, as text
+//
+// A client can have any number of requests outstanding on one connection;
+// responses to them can come back in any order, which is what the tags are for.
+//
+enum class multiply_message : std::uint8_t { multiply = 1, product = 2, error = 3 };
+const std::size_t multiply_frame_header_size = 12;
+
+// frames longer than this get the connection dropped (without reading them)
+const std::size_t default_max_frame_bytes = std::size_t(1) << 30;
+
+// requests the server hands to the pool at once
+const std::size_t default_server_max_batch = 64;
+
+// requests with an operand longer than this are multiplied as batches of
+// their own, so the small requests queued along with them don't wait on them
+const unsigned long server_solo_request_digits = 16384;
+
+// replies waiting to go out on one connection before it's hung up on (a
+// client that stops reading mustn't hold up everyone else, or fill the memory)
+const std::size_t default_max_reply_backlog_bytes = std::size_t(1) << 30;
+
+
+
+class MultiplyServer
+//
+// Listens on a Unix domain socket. A thread per connection reads requests off
+// it into one shared queue; a dispatcher takes whatever has queued up (up to
+// max_batch) and forks a task onto the pool to multiply the lot together with
+// multiply_batch (several of them can be running at once, and big requests
+// get tasks of their own), which hands each product to the connection its
+// request came in on. Each connection has a writer thread of its own sending
+// its replies, so no multiply ever waits on a client; one that lets more than
+// max_backlog_bytes of replies pile up is hung up on.
+//
+{
+public:
+    struct counters
+    {
+        std::atomic<unsigned long> connections {0};
+        std::atomic<unsigned long> requests {0};
+        std::atomic<unsigned long> batches {0};
+        std::atomic<unsigned long> errors {0};     // bad requests (answered with an error frame)
+        std::atomic<unsigned long> dropped {0};    // connections hung up on for not reading their replies
+    };
+
+private:
+    struct connection;
+    struct pending;
+
+    std::filesystem::path socket_path;
+    WorkStealingPool& pool;
+    std::size_t max_batch;
+    std::size_t max_frame_bytes;
+    std::size_t max_backlog_bytes;
+
+    int listen_fd = -1;
+    int wake_fds[2] = { -1, -1 };     // stop() writes to [1] to wake run() up
+    std::mutex run_lock;              // (run() is once at a time)
+    counters stats;
+
+    void read_requests( const std::shared_ptr<connection>& conn, BoundedQueue<pending>& queue );
+    void dispatch( BoundedQueue<pending>& queue );
+
+public:
+    // constructors: binds and listens straight away (replacing a stale socket
+    // file at socket_path, but nothing else; if a server is still listening
+    // on it, throws std::system_error), so clients can connect as soon as it
+    // returns, even if run() hasn't started yet
+    explicit MultiplyServer( const std::filesystem::path& socket_path,
+                             WorkStealingPool& pool = WorkStealingPool::shared(),
+                             std::size_t max_batch = default_server_max_batch,
+                             std::size_t max_frame_bytes = default_max_frame_bytes,
+                             std::size_t max_backlog_bytes = default_max_reply_backlog_bytes );
+    ~MultiplyServer();
+
+    // copy & move semantics (threads in run() hold 'this', so neither)
+    MultiplyServer( const MultiplyServer& ) = delete;
+    MultiplyServer& operator=( const MultiplyServer& ) = delete;
+
+    // serve until stop() is called; requests already read get answered before
+    // it returns (a client that isn't reading its replies gets a couple of
+    // seconds to start, then is hung up on). Throws std::system_error if it
+    // can't wait for connections (once it has shut down what's running).
+    void run();
+
+    // make run() return (from any thread, or a signal-waiting one)
+    void stop();
+
+    const counters& statistics() const { return stats; }
+    const std::filesystem::path& path() const { return socket_path; }
+};
+
+
+
+class MultiplyClient
+//
+// One connection to a MultiplyServer
+//
+{
+    int fd = -1;
+    std::uint32_t next_tag = 1;
+    std::size_t max_frame_bytes;
+
+public:
+    // constructors
+    explicit MultiplyClient( const std::filesystem::path& socket_path,
+                             std::size_t max_frame_bytes = default_max_frame_bytes );
+    ~MultiplyClient();
+
+    // copy & move semantics / construction
+    MultiplyClient( const MultiplyClient& ) = delete;
+    MultiplyClient( MultiplyClient&& that );
+    MultiplyClient& operator=( const MultiplyClient& ) = delete;
+    MultiplyClient& operator=( MultiplyClient&& that );
+
+    // one round trip; throws std::runtime_error if the server sends back an
+    // error, or the connection goes away
+    IntList multiply( const IntList& x, const IntList& y );
+};
+
+#endif // __multiply_server_h
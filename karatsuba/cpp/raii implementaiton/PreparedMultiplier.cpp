@@ -0,0 +1,310 @@
+//
+// PreparedMultiplier.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// class definitions for a multiplier prepared once for any number of
+// Karatsuba multiplies (using RAII patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_PREPAREDMULTIPLIER_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp PreparedMultiplier.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_PREPAREDMULTIPLIER_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE PreparedMultiplier Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_PREPAREDMULTIPLIER_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SparseIntList.h"
+#include "IntListAccumulator.h"
+#include "karatsuba.h"
+#include "PreparedMultiplier.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// ===============================================================================
+// class PreparedMultiplier constructors
+// ===============================================================================
+
+// *******************************************************************************
+// PreparedMultiplier::PreparedMultiplier / PreparedMultiplier::build
+// *******************************************************************************
+//
+// Split y just as karatsuba would split it against an operand as long as it is,
+// and keep going into the three sub-products' multiplier sides (c, d and c+d)
+// until they're down to leaf size, or as far as the budget goes. That's done a
+// level at a time, so it can stop at the first level that won't fit: a split
+// node's three children are (nominally) half as long again as it, plus one,
+// so each level's size is known before it's made. Sparse multipliers aren't prepared at
+// all: karatsuba multiplies those block by block, which beats any of this.
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+PreparedMultiplier::PreparedMultiplier( const IntList& y, unsigned long leaf_digits ) :
+    y( y.clone() ), sparse( SparseIntList::should_be_sparse( y ) )
+{
+    if ( leaf_digits < 3 || leaf_digits > max_prepared_leaf_digits )
+        throw std::invalid_argument( "leaf_digits must be from 3 to " + std::to_string( max_prepared_leaf_digits ) );
+
+    if ( !sparse )
+        build( leaf_digits );
+}
+//
+void PreparedMultiplier::build( unsigned long leaf_digits )
+{
+    root = std::make_unique<node>();
+    root->digits = y.size();
+
+    // the nodes at the bottom so far, each with its piece of y
+    std::vector<std::pair<node*, IntList>> bottom;
+    bottom.emplace_back( root.get(), y.clone() );
+
+    const auto budget = prepared_digits_factor * y.size();
+    for (;;) {
+        unsigned long next_digits = 0;
+        bool any_split = false;
+        for ( const auto& [n, v] : bottom ) {
+            bool split = n->digits > leaf_digits;
+            next_digits += split ? n->digits + karatsuba_split_point( n->digits ) + 1 : n->digits;
+            any_split |= split;
+        }
+        if ( !any_split || next_digits > budget )
+            break;
+
+        std::vector<std::pair<node*, IntList>> next;
+        for ( auto& [n, v] : bottom ) {
+            if ( n->digits <= leaf_digits ) {
+                next.emplace_back( n, std::move( v ) );
+                continue;
+            }
+
+            auto child = [&next]( std::unique_ptr<node>& to, unsigned long digits, IntList& piece ) {
+                to = std::make_unique<node>();
+                to->digits = digits;
+                next.emplace_back( to.get(), std::move( piece ) );
+            };
+            n->m = karatsuba_split_point( n->digits );
+            auto [c, d, c_d] = split_into_halves( v, n->digits );
+            child( n->hi,  n->digits - n->m, c   );
+            child( n->lo,  n->m,             d   );
+            child( n->sum, n->m + 1,         c_d );     // (c+d can carry into one more digit)
+        }
+        bottom = std::move( next );
+    }
+
+    for ( auto& [n, v] : bottom ) {
+        stored += v.size();
+        if ( n->digits <= leaf_digits )
+            n->y = FixedIntList<max_prepared_leaf_digits>( v );
+        else
+            n->whole = std::move( v );
+    }
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_prepared_multiplier_construction )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // the multiplier is kept, and split down to leaves (as small as 3
+        // digits, as big as the kernel takes)
+        //
+        auto y = random_int_list( 777 );
+        PreparedMultiplier prepared( y );
+        BOOST_CHECK( prepared.multiplier() == y );
+        BOOST_CHECK( prepared.prepared_digits() > y.size() );
+
+        BOOST_CHECK( PreparedMultiplier( y, 3 ).prepared_digits() > prepared.prepared_digits() );
+        BOOST_CHECK( PreparedMultiplier( y, max_prepared_leaf_digits ).prepared_digits() > 0 );
+        BOOST_CHECK_THROW( PreparedMultiplier( y, 2 ), std::invalid_argument );
+        BOOST_CHECK_THROW( PreparedMultiplier( y, max_prepared_leaf_digits + 1 ), std::invalid_argument );
+
+        // one that fits in a leaf is just the leaf
+        BOOST_CHECK( PreparedMultiplier( IntList( 12345 ) ).prepared_digits() == 5 );
+    }
+
+    {   //
+        // a long multiplier only gets as many levels as fit in the budget
+        // (all of them would be over 60 times its length)
+        //
+        auto y = random_int_list( 100000 );
+        PreparedMultiplier prepared( y );
+        BOOST_CHECK( prepared.prepared_digits() > y.size() );
+        BOOST_CHECK( prepared.prepared_digits() <= prepared_digits_factor * y.size() );
+
+        // and so does a short one with the smallest leaves
+        auto z = random_int_list( 2000 );
+        BOOST_CHECK( PreparedMultiplier( z, 3 ).prepared_digits() <= prepared_digits_factor * z.size() );
+    }
+
+    {   //
+        // a sparse multiplier (10^600 + 7) isn't prepared at all
+        //
+        std::vector<IntList::value_type> v( 601, 0 );
+        v[0] = 1; v[600] = 7;
+        IntList y( v );
+        PreparedMultiplier prepared( y );
+        BOOST_CHECK( prepared.prepared_digits() == 0 );
+        BOOST_CHECK( prepared.multiplier() == y );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class PreparedMultiplier methods
+// ===============================================================================
+
+// *******************************************************************************
+// PreparedMultiplier::multiply
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList PreparedMultiplier::multiply( const node& n, const IntList& x )
+{
+    if ( n.whole )
+        return karatsuba( x, *n.whole );
+
+    if ( n.m == 0 )
+        return ( FixedIntList<max_prepared_leaf_digits>( x ) * n.y ).to_int_list();
+
+    auto [a, b, a_b] = split_into_halves( x, n.digits );
+
+    auto s1    = multiply( *n.hi,  a   );
+    auto s2    = multiply( *n.lo,  b   );
+    auto s1xs2 = multiply( *n.sum, a_b );
+    return karatsuba_join( s1, s2, s1xs2, n.m );
+}
+//
+IntList PreparedMultiplier::multiply( const IntList& x ) const
+{
+    if ( sparse )
+        return karatsuba( x, y );
+
+    const auto n = root->digits;
+    if ( x.size() <= n )
+        return multiply( *root, x );
+
+    //
+    // longer than y: n-digit pieces from the lsd end, each added in at its
+    // offset
+    //
+    IntListAccumulator acc( x.size() + n + 1 );
+    for ( const auto& [piece, offset] : lsd_pieces( x, n ) )
+        acc.add_shifted( multiply( *root, piece ), offset );
+    return acc.finish();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_prepared_multiplier_multiply )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // shorter, as long and longer than the multiplier, against karatsuba
+        //
+        for ( unsigned long y_digits : { 1ul, 2ul, 31ul, 33ul, 100ul, 777ul, 2048ul } ) {
+            auto y = random_int_list( y_digits );
+            PreparedMultiplier prepared( y );
+            BOOST_CHECK( prepared.multiplier() == y );
+
+            for ( unsigned long x_digits : { 1ul, y_digits / 2 + 1, y_digits, y_digits + 1, 3*y_digits + 5 } ) {
+                auto x = random_int_list( x_digits );
+                BOOST_CHECK( prepared.multiply( x ) == karatsuba( x, y ) );
+            }
+            BOOST_CHECK( prepared.multiply( IntList( 0 ) ) == IntList( 0 ) );
+        }
+    }
+
+    {   //
+        // all nines, so every sum at every level carries (both sides), and the
+        // smallest leaves there are
+        //
+        IntList nines( std::vector<IntList::value_type>( 500, 9 ) );
+        PreparedMultiplier prepared( nines, 3 );
+        BOOST_CHECK( prepared.multiply( nines ) == karatsuba( nines, nines ) );
+
+        auto x = random_int_list( 321 );
+        BOOST_CHECK( prepared.multiply( x ) == karatsuba( x, nines ) );
+    }
+
+    {   //
+        // a sparse multiplier (10^600 + 7) goes block by block
+        //
+        std::vector<IntList::value_type> v( 601, 0 );
+        v[0] = 1; v[600] = 7;
+        IntList y( v );
+        PreparedMultiplier prepared( y );
+
+        auto x = random_int_list( 900 );
+        BOOST_CHECK( prepared.multiply( x ) == karatsuba( x, y ) );
+    }
+
+    {   //
+        // one that stopped short of the leaves (its bottom nodes multiply by
+        // karatsuba), shorter, as long and longer
+        //
+        auto y = random_int_list( 20000 );
+        PreparedMultiplier prepared( y );
+        BOOST_CHECK( prepared.prepared_digits() <= prepared_digits_factor * y.size() );
+
+        for ( unsigned long x_digits : { 700ul, 20000ul, 45000ul } ) {
+            auto x = random_int_list( x_digits );
+            BOOST_CHECK( prepared.multiply( x ) == karatsuba( x, y ) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_prepared_multiplier_between_threads )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // one multiplier shared between threads
+        //
+        auto y = random_int_list( 1500 );
+        PreparedMultiplier prepared( y );
+
+        std::vector<IntList> xs;
+        for ( int i=0; i < 16; i++ )
+            xs.push_back( random_int_list( 1 + std::rand() % 3000 ) );
+
+        auto products = products_between_threads( 16, [&]( int i ) { return prepared.multiply( xs[i] ); } );
+        for ( int i=0; i < 16; i++ )
+            BOOST_CHECK( products[i] == karatsuba( xs[i], y ) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+//
+// PreparedMultiplier.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class declaration for a multiplier that's been prepared once for any number
+// of Karatsuba multiplies (using RAII patterns), for workloads that keep
+// multiplying by the same few constants.
+//
+#ifndef __prepared_multiplier_h
+#define __prepared_multiplier_h
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include "IntList.h"
+#include "FixedIntList.h"
+
+// pieces of the multiplier this long or shorter are kept ready for the
+// schoolbook kernel to multiply out; anywhere from 3 (for the recursion to get
+// anywhere) up to the kernel's size
+const unsigned long max_prepared_leaf_digits = 32;
+const unsigned long default_prepared_leaf_digits = max_prepared_leaf_digits;
+
+// levels are only prepared while everything kept stays within this many
+// times the multiplier's own length
+const unsigned long prepared_digits_factor = 16;
+
+class PreparedMultiplier
+//
+// A fixed multiplier y, with its side of the Karatsuba recursion worked out up
+// front: the halves it's split into at every level, and the sums of those
+// halves, all the way down to the leaves (already in the kernel's fixed form).
+// multiply(x) then only has to split x and add up x's halves as it goes.
+//
+// For that, the splits can't depend on x: each level works at a nominal length
+// (y's length at the top), with x zero-padded to it; the sum sub-product gets
+// one extra digit, to hold a carry out of either sum. Anything longer than y is
+// multiplied a y-length piece at a time.
+//
+// Keeping every level would cost about (y digits / leaf digits)^0.58 times y's
+// own size, and past a few thousand digits the splitting it saves is a small
+// part of the work anyway; so levels are only prepared down to where the next
+// would take more than prepared_digits_factor times y's length, and the nodes
+// there keep their piece of y whole and leave the rest of the recursion to
+// karatsuba.
+//
+{
+private:
+    struct node
+    {
+        unsigned long digits;               // nominal length here
+        unsigned long m = 0;                // split point (0 if it isn't split)
+        FixedIntList<max_prepared_leaf_digits> y;   // (leaves only)
+        std::optional<IntList> whole;       // (where preparing stopped short of the leaves)
+        std::unique_ptr<node> hi, lo, sum;  // sub-products with c, d and c+d
+    };
+
+    IntList y;
+    bool sparse;
+    std::unique_ptr<node> root;
+    std::size_t stored = 0;
+
+    void build( unsigned long leaf_digits );
+    static IntList multiply( const node& n, const IntList& x );
+
+public:
+    // constructors
+    explicit PreparedMultiplier( const IntList& y, unsigned long leaf_digits = default_prepared_leaf_digits );
+
+    // copy & move semantics
+    PreparedMultiplier( const PreparedMultiplier& ) = delete;
+    PreparedMultiplier( PreparedMultiplier&& ) = default;
+    PreparedMultiplier& operator=( const PreparedMultiplier& ) = delete;
+    PreparedMultiplier& operator=( PreparedMultiplier&& ) = default;
+
+    // x*y (the prepared tree is only read, so threads can share a multiplier)
+    IntList multiply( const IntList& x ) const;
+
+    const IntList& multiplier() const { return y; }
+    std::size_t prepared_digits() const { return stored; }   // digits kept at the bottom of every branch
+};
+
+#endif // __prepared_multiplier_h
@@ -0,0 +1,348 @@
+//
+// ProductCache.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// class definitions for a bounded, thread-safe cache of products (using RAII
+// patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_PRODUCTCACHE_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp ProductCache.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_PRODUCTCACHE_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE ProductCache Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_PRODUCTCACHE_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <vector>
+
+#include "SparseIntList.h"
+#include "karatsuba.h"
+#include "ProductCache.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+// bookkeeping charged to every entry on top of its digits (list and index
+// nodes, and the three IntLists' own headers)
+static const std::size_t entry_overhead_bytes = 160;
+
+
+
+// ===============================================================================
+// class ProductCache constructors
+// ===============================================================================
+
+ProductCache::ProductCache( std::size_t budget_bytes ) : budget( budget_bytes ) {}
+
+
+
+// ===============================================================================
+// class ProductCache methods
+// ===============================================================================
+
+// *******************************************************************************
+// ProductCache::key_for
+// *******************************************************************************
+//
+// The two operand hashes, smaller first, mixed together: the same key for x*y
+// as for y*x, without x*x collapsing to a constant the way a plain xor would.
+// (Both are cached in the operands, so repeat lookups don't rehash them.)
+//
+std::uint64_t ProductCache::key_for( const IntList& x, const IntList& y )
+{
+    std::uint64_t a = std::hash<IntList>{}( x );
+    std::uint64_t b = std::hash<IntList>{}( y );
+    if ( a > b )
+        std::swap( a, b );
+    return std::rotl( a * 0x9E3779B97F4A7C15ULL, 23 ) ^ b;
+}
+
+
+
+// *******************************************************************************
+// ProductCache::find / ProductCache::insert
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::optional<IntList> ProductCache::find( const IntList& x, const IntList& y )
+{
+    const auto key = key_for( x, y );
+
+    std::lock_guard<std::mutex> guard( lock );
+    auto [first, last] = index.equal_range( key );
+    for ( auto i = first; i != last; ++i ) {
+        auto e = i->second;
+        if ( (e->x == x && e->y == y) || (e->x == y && e->y == x) ) {
+            entries.splice( entries.begin(), entries, e );
+            ++stats.hits;
+            return e->product.clone();
+        }
+    }
+    ++stats.misses;
+    return std::nullopt;
+}
+//
+void ProductCache::insert( const IntList& x, const IntList& y, const IntList& product )
+{
+    const std::size_t bytes = (x.size() + y.size() + product.size()) * sizeof(IntList::value_type) +
+                              entry_overhead_bytes;
+    if ( bytes > budget )
+        return;
+
+    // (copied before taking the lock)
+    entry e { key_for( x, y ), x.clone(), y.clone(), product.clone(), bytes };
+
+    std::lock_guard<std::mutex> guard( lock );
+    auto [first, last] = index.equal_range( e.key );
+    for ( auto i = first; i != last; ++i )
+        if ( (i->second->x == x && i->second->y == y) || (i->second->x == y && i->second->y == x) )
+            return;     // another thread got there first
+
+    evict_down_to( budget - bytes );
+    entries.push_front( std::move(e) );
+    index.emplace( entries.front().key, entries.begin() );
+    used += bytes;
+    ++stats.insertions;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_product_cache_find_insert )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // hits either way round, misses on anything else
+        //
+        ProductCache cache;
+        auto x = random_int_list( 300 ), y = random_int_list( 200 );
+        BOOST_CHECK( !cache.find( x, y ) );
+
+        cache.insert( x, y, karatsuba( x, y ) );
+        BOOST_CHECK( cache.size() == 1 );
+        BOOST_CHECK( cache.find( x, y ) == karatsuba( x, y ) );
+        BOOST_CHECK( cache.find( y, x ) == karatsuba( x, y ) );
+        BOOST_CHECK( !cache.find( x, x ) );
+
+        auto s = cache.statistics();
+        BOOST_CHECK( s.hits == 2 && s.misses == 2 && s.insertions == 1 && s.evictions == 0 );
+
+        cache.insert( y, x, karatsuba( x, y ) );    // (already there)
+        BOOST_CHECK( cache.size() == 1 );
+        cache.clear();
+        BOOST_CHECK( cache.size() == 0 && cache.bytes() == 0 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// ProductCache::evict_down_to (called with the lock held)
+// *******************************************************************************
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void ProductCache::evict_down_to( std::size_t bytes )
+{
+    while ( used > bytes && !entries.empty() ) {
+        auto e = std::prev( entries.end() );
+
+        auto [first, last] = index.equal_range( e->key );
+        for ( auto i = first; i != last; ++i )
+            if ( i->second == e ) {
+                index.erase( i );
+                break;
+            }
+
+        used -= e->bytes;
+        entries.erase( e );
+        ++stats.evictions;
+    }
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_product_cache_eviction )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // least recently used goes first, and the budget holds
+        //
+        const std::size_t entry_bytes = (100 + 100 + 200) * sizeof(IntList::value_type) + entry_overhead_bytes;
+        ProductCache cache( entry_bytes * 3 );
+
+        std::vector<IntList> xs;
+        for ( int i=0; i < 4; i++ )
+            xs.push_back( random_int_list( 100 ) );
+        auto square = [&]( int i ) { return karatsuba( xs[i], xs[i] ); };
+
+        for ( int i=0; i < 3; i++ )
+            cache.insert( xs[i], xs[i], square(i) );
+        BOOST_CHECK( cache.find( xs[0], xs[0] ) );      // 1 is now the oldest
+        cache.insert( xs[3], xs[3], square(3) );
+
+        BOOST_CHECK( cache.size() == 3 );
+        BOOST_CHECK( cache.bytes() <= entry_bytes * 3 );
+        BOOST_CHECK( !cache.find( xs[1], xs[1] ) );
+        BOOST_CHECK( cache.find( xs[0], xs[0] ) && cache.find( xs[2], xs[2] ) && cache.find( xs[3], xs[3] ) );
+        BOOST_CHECK( cache.statistics().evictions == 1 );
+
+        ProductCache tiny( 100 );
+        tiny.insert( xs[0], xs[0], square(0) );
+        BOOST_CHECK( tiny.size() == 0 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// ProductCache::clear / statistics / bytes / size
+// *******************************************************************************
+//
+void ProductCache::clear()
+{
+    std::lock_guard<std::mutex> guard( lock );
+    index.clear();
+    entries.clear();
+    used = 0;
+}
+//
+ProductCache::counters ProductCache::statistics() const
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return stats;
+}
+//
+std::size_t ProductCache::bytes() const
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return used;
+}
+//
+std::size_t ProductCache::size() const
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return entries.size();
+}
+
+
+
+// *******************************************************************************
+// Calculate a product by Karatsuba multiplication, through a product cache.
+// Each level looks its operands up first, and on a miss recurses on its three
+// sub-products (each of which does the same) before remembering its own
+// product, so a repeat of any sub-product big enough to be cached, in this
+// multiply or any earlier one, is a lookup. Sparse operands go to karatsuba in
+// one piece, since it multiplies those its own way.
+// *******************************************************************************
+//
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList karatsuba_cached(const IntList& x, const IntList& y, ProductCache& cache, unsigned long min_cached_digits) {
+
+    auto digits = std::max( x.size(), y.size() );
+    if ( digits < min_cached_digits || digits < 2 )
+        return karatsuba( x, y );
+
+    if ( auto hit = cache.find( x, y ) )
+        return std::move( *hit );
+
+    IntList product( 0 );
+    if ( SparseIntList::should_be_sparse(x) || SparseIntList::should_be_sparse(y) )
+        product = karatsuba( x, y );
+    else {
+        auto step = karatsuba_split( x, y );
+        auto s1    = karatsuba_cached( step.s1.first,    step.s1.second,    cache, min_cached_digits );
+        auto s2    = karatsuba_cached( step.s2.first,    step.s2.second,    cache, min_cached_digits );
+        auto s1xs2 = karatsuba_cached( step.s1xs2.first, step.s1xs2.second, cache, min_cached_digits );
+        product = karatsuba_join( s1, s2, s1xs2, step.m );
+    }
+
+    cache.insert( x, y, product );
+    return product;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_karatsuba_cached )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // the recursion finds its own repeats: all-nines operands split into
+        // equal halves all the way down
+        //
+        ProductCache cache;
+        IntList nines( std::vector<IntList::value_type>( 4096, 9 ) );
+        BOOST_CHECK( karatsuba_cached( nines, nines, cache, 64 ) == karatsuba( nines, nines ) );
+        BOOST_CHECK( cache.statistics().hits > 0 );
+
+        // and random values come out right (and hit on the second go)
+        auto x = random_int_list( 2000 ), y = random_int_list( 1700 );
+        BOOST_CHECK( karatsuba_cached( x, y, cache, 64 ) == karatsuba( x, y ) );
+        auto hits = cache.statistics().hits;
+        BOOST_CHECK( karatsuba_cached( y, x, cache, 64 ) == karatsuba( x, y ) );
+        BOOST_CHECK( cache.statistics().hits == hits + 1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_karatsuba_cached_between_threads )
+{
+    std::srand(time(nullptr));
+
+    {   //
+        // shared between threads
+        //
+        ProductCache cache( 1 << 20 );
+        std::vector<IntList> xs;
+        for ( int i=0; i < 8; i++ )
+            xs.push_back( random_int_list( 600 + std::rand() % 600 ) );
+
+        // (every pair of them, two or three times over)
+        auto products = products_between_threads( 160, [&]( int i ) {
+            return karatsuba_cached( xs[i % 8], xs[i / 8 % 8], cache, 128 );
+        } );
+        for ( int i=0; i < 160; i++ )
+            BOOST_CHECK( products[i] == karatsuba( xs[i % 8], xs[i / 8 % 8] ) );
+        BOOST_CHECK( cache.bytes() <= std::size_t(1) << 20 );
+        BOOST_CHECK( cache.statistics().hits > 0 );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+//
+// ProductCache.h
+//
+// created by PKXH on 19 Oct 2026
+//
+// class declaration for a bounded, thread-safe cache of products (using RAII
+// patterns), for workloads that keep multiplying the same operands.
+//
+#ifndef __product_cache_h
+#define __product_cache_h
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "IntList.h"
+
+const std::size_t default_product_cache_bytes = std::size_t(64) << 20;
+
+// sub-products shorter than this aren't worth a lookup (or the room)
+const unsigned long default_min_cached_digits = 512;
+
+class ProductCache
+//
+// Products keyed by their operands, either way round, evicted least recently
+// used first once the entries' memory (operands and product) passes the
+// budget. Entries are found by a hash of the operands and then compared
+// digit for digit, so a hash collision can cost a miss but never a wrong
+// answer.
+//
+{
+public:
+    struct counters
+    {
+        unsigned long hits = 0;
+        unsigned long misses = 0;
+        unsigned long insertions = 0;
+        unsigned long evictions = 0;
+    };
+
+private:
+    struct entry
+    {
+        std::uint64_t key;
+        IntList x, y, product;
+        std::size_t bytes;
+    };
+
+    std::size_t budget;
+    std::size_t used = 0;
+    std::list<entry> entries;           // most recently used first
+    std::unordered_multimap<std::uint64_t, std::list<entry>::iterator> index;
+    counters stats;
+    mutable std::mutex lock;
+
+    static std::uint64_t key_for( const IntList& x, const IntList& y );
+    void evict_down_to( std::size_t bytes );
+
+public:
+    // constructors
+    explicit ProductCache( std::size_t budget_bytes = default_product_cache_bytes );
+
+    // copy & move semantics (a shared cache is shared by reference, so neither)
+    ProductCache( const ProductCache& ) = delete;
+    ProductCache& operator=( const ProductCache& ) = delete;
+
+    // x*y (a copy of it) if it's cached, counting a hit or a miss
+    std::optional<IntList> find( const IntList& x, const IntList& y );
+
+    // remember x*y = product (anything bigger than the whole budget is skipped)
+    void insert( const IntList& x, const IntList& y, const IntList& product );
+
+    void clear();
+    counters statistics() const;
+    std::size_t bytes() const;          // memory the entries are charged for
+    std::size_t size() const;           // entries
+};
+
+// x*y, going through the cache at every level of the recursion with operands
+// at least min_cached_digits long, so repeated sub-products (which structured
+// operands are full of) are looked up rather than worked out again
+IntList karatsuba_cached(const IntList& x, const IntList& y, ProductCache& cache,
+                         unsigned long min_cached_digits = default_min_cached_digits);
+
+#endif // __product_cache_h
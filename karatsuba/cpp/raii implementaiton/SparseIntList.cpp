@@ -0,0 +1,683 @@
+//
+// SparseIntList.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// class definitions for sparse integer list type (using RAII patterns)
+// (ex: 7000000000000000042 is stored as the blocks [7] and [4,2], with the
+// zeros between them implied by the blocks' offsets)
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_SPARSEINTLIST_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE SparseIntList Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_SPARSEINTLIST_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "SparseIntList.h"
+
+
+
+// ===============================================================================
+// class SparseIntList::builder
+// ===============================================================================
+
+// *******************************************************************************
+// SparseIntList::builder
+// *******************************************************************************
+//
+// Collects digits handed to it lsd-first (at strictly increasing powers of 10)
+// and packs the non-zero ones into blocks, starting a new block whenever the
+// zero run since the last non-zero digit is at least min_zero_run long.
+//
+// *******************************************************************************
+//
+class SparseIntList::builder
+{
+    std::vector<block> blocks;
+    std::vector<value_type> run; // current block, lsd first
+    unsigned long run_offset = 0;
+
+    void close_run()
+    {
+        if (run.empty())
+            return;
+        std::reverse( run.begin(), run.end() ); // blocks are msd-first
+        blocks.push_back( block{ run_offset, std::move(run) } );
+        run.clear();
+    }
+
+public:
+    void put( unsigned long pos, value_type d )
+    {
+        if (d == 0)
+            return; // zeros are implied by the gaps
+
+        if (!run.empty() && pos - (run_offset + run.size()) < min_zero_run)
+            run.resize( pos - run_offset, 0 );  // short zero run stays in the block
+        else {
+            close_run();
+            run_offset = pos;
+        }
+        run.push_back(d);
+    }
+
+    std::vector<block> finish()
+    {
+        close_run();
+        return std::move(blocks);
+    }
+};
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+// (exercised through the constructors and operators below)
+//
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// merged_spans
+// *******************************************************************************
+//
+// Given the blocks of two sparse values, return the (ascending, non-touching)
+// [lo,hi) digit ranges covered by either of them. Everything outside of these
+// ranges is zero in both values.
+//
+// *******************************************************************************
+//
+static std::vector<std::pair<unsigned long, unsigned long>> merged_spans(
+    const std::vector<SparseIntList::block>& a,
+    const std::vector<SparseIntList::block>& b )
+{
+    std::vector<std::pair<unsigned long, unsigned long>> spans;
+    spans.reserve( a.size() + b.size() );
+
+    auto ai = a.begin();
+    auto bi = b.begin();
+    while ( ai != a.end() || bi != b.end() ) {
+        auto& next = ( bi == b.end() || (ai != a.end() && ai->offset <= bi->offset) ) ? *ai++ : *bi++;
+
+        if (!spans.empty() && next.offset <= spans.back().second)
+            spans.back().second = std::max( spans.back().second, next.end() );
+        else
+            spans.emplace_back( next.offset, next.end() );
+    }
+    return spans;
+}
+
+
+
+// *******************************************************************************
+// block_cursor
+// *******************************************************************************
+//
+// Reads the digits of a block list at non-decreasing powers of 10 without
+// searching from the start each time.
+//
+// *******************************************************************************
+//
+namespace {
+class block_cursor
+{
+    const std::vector<SparseIntList::block>& blocks;
+    std::size_t i = 0;
+
+public:
+    block_cursor( const std::vector<SparseIntList::block>& blocks ) : blocks(blocks) {}
+
+    SparseIntList::value_type at( unsigned long pos )
+    {
+        while ( i < blocks.size() && blocks[i].end() <= pos )
+            ++i;
+        if ( i == blocks.size() || pos < blocks[i].offset )
+            return 0;
+        const auto& b = blocks[i];
+        return b.digits[ b.digits.size() - 1 - (pos - b.offset) ];
+    }
+};
+}
+
+
+
+// ===============================================================================
+// class SparseIntList constructors
+// ===============================================================================
+
+// *******************************************************************************
+// SparseIntList::SparseIntList (initialize from blocks)
+// *******************************************************************************
+//
+// take ownership of an already-normalized block list.
+//
+// *******************************************************************************
+//
+SparseIntList::SparseIntList( std::vector<block>&& blks )
+    : blocks( std::move(blks) )
+    , num_digits( blocks.empty() ? 1 : blocks.back().end() )
+{
+}
+
+
+
+// *******************************************************************************
+// SparseIntList::SparseIntList (initialize from IntList)
+// *******************************************************************************
+//
+// walk the dense digits lsd-first and keep only the non-zero blocks.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+SparseIntList::SparseIntList( const IntList& il )
+{
+    builder b;
+    unsigned long pos = 0;
+    for ( auto p = il.crbegin(); p != il.crend(); ++p )
+        b.put( pos++, *p );
+
+    blocks = b.finish();
+    num_digits = blocks.empty() ? 1 : blocks.back().end();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_intlist_initialization_tests)
+{
+    {   //
+        // zero has no blocks at all
+        //
+        SparseIntList s( IntList(0) );
+        BOOST_CHECK( s.get_blocks().empty() );
+        BOOST_CHECK( s.size() == 1 );
+        BOOST_CHECK( s.to_str() == "0" );
+    }
+
+    {   //
+        // short zero runs stay inside a block; trailing zeros are dropped
+        //
+        SparseIntList s( IntList {1,0,2,0,0,0} );
+        BOOST_CHECK( s.get_blocks().size() == 1 );
+        BOOST_CHECK( s.get_blocks()[0].offset == 3 );
+        BOOST_CHECK( s.get_blocks()[0].digits == (std::vector<unsigned int>{1,0,2}) );
+        BOOST_CHECK( s.size() == 6 );
+    }
+
+    {   //
+        // long zero runs split the value into blocks
+        //
+        SparseIntList s( IntList {4,2,0,0,0,0,0,0,0,0,0,0,7} );
+        BOOST_CHECK( s.get_blocks().size() == 2 );
+        BOOST_CHECK( s.get_blocks()[0].offset == 0  );
+        BOOST_CHECK( s.get_blocks()[0].digits == (std::vector<unsigned int>{7}) );
+        BOOST_CHECK( s.get_blocks()[1].offset == 11 );
+        BOOST_CHECK( s.get_blocks()[1].digits == (std::vector<unsigned int>{4,2}) );
+        BOOST_CHECK( s.stored_digits() == 3 );
+        BOOST_CHECK( s.to_str() == "4200000000007" );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// ===============================================================================
+// class SparseIntList methods
+// ===============================================================================
+
+// *******************************************************************************
+// SparseIntList::clone
+// *******************************************************************************
+//
+// return a clone of this sparse integer list.
+//
+// *******************************************************************************
+//
+SparseIntList SparseIntList::clone() const
+{
+    auto blks = blocks;
+    return SparseIntList( std::move(blks) );
+}
+
+
+
+// *******************************************************************************
+// SparseIntList::to_int_list / SparseIntList::to_str
+// *******************************************************************************
+//
+// expand back out to the dense representation (or its string).
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+IntList SparseIntList::to_int_list() const
+{
+    std::vector<value_type> dense( num_digits, 0 );
+    for ( const auto& b : blocks )
+        std::copy( b.digits.begin(), b.digits.end(), dense.end() - b.end() );
+    return IntList( dense );
+}
+//
+std::string SparseIntList::to_str() const
+{
+    std::string str( num_digits, '0' );
+    for ( const auto& b : blocks ) {
+        auto out = str.end() - b.end();
+        for ( auto d : b.digits )
+            *out++ = '0' + d;
+    }
+    return str;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_round_trip_tests)
+{
+    std::srand(time(nullptr));
+
+    for ( int i=0; i < 200; i++ ) {
+        //
+        // build random values that are mostly zeros and make sure they survive
+        // the trip to sparse and back
+        //
+        std::vector<unsigned int> v( 1 + std::rand() % 200, 0 );
+        v[0] = 1 + std::rand() % 9;
+        for ( int j = std::rand() % 10; j > 0; --j )
+            v[ std::rand() % v.size() ] = std::rand() % 10;
+
+        IntList il( v );
+        SparseIntList s( il );
+
+        BOOST_CHECK( s.to_int_list() == il );
+        BOOST_CHECK( s.to_str() == il.to_str() );
+        BOOST_CHECK( s.size() == il.size() );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// SparseIntList::stored_digits / SparseIntList::density
+// *******************************************************************************
+//
+// How many digits the blocks actually hold, and what fraction of the full value
+// that is. The static version answers the same question for a dense IntList
+// without building the sparse one.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+unsigned long SparseIntList::stored_digits() const
+{
+    unsigned long n = 0;
+    for ( const auto& b : blocks )
+        n += b.digits.size();
+    return n;
+}
+//
+double SparseIntList::density() const
+{
+    return double( stored_digits() ) / double( num_digits );
+}
+//
+double SparseIntList::density( const IntList& il )
+{   //
+    // count the digits that would be skipped: every zero run of at least
+    // min_zero_run digits, plus whatever zeros trail the lsd block.
+    //
+    unsigned long skipped = 0;
+    unsigned long zeros = 0;
+    for ( auto p = il.cbegin(); p != il.cend(); ++p ) {
+        if (*p == 0)
+            ++zeros;
+        else {
+            if (zeros >= min_zero_run)
+                skipped += zeros;
+            zeros = 0;
+        }
+    }
+    skipped += zeros;
+
+    return double( il.size() - skipped ) / double( il.size() );
+}
+//
+bool SparseIntList::should_be_sparse( const IntList& il )
+{
+    return il.size() >= min_sparse_size && density(il) <= density_threshold;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_density_tests)
+{
+    {   //
+        // 10^100 + 1 is about as sparse as it gets
+        //
+        std::vector<unsigned int> v( 101, 0 );
+        v[0] = v[100] = 1;
+        IntList il( v );
+
+        BOOST_CHECK( SparseIntList::density(il) == SparseIntList(il).density() );
+        BOOST_CHECK( SparseIntList::density(il) < 0.05 );
+        BOOST_CHECK( SparseIntList::should_be_sparse(il) );
+    }
+
+    {   //
+        // ...while a value with no long zero runs is fully dense
+        //
+        std::vector<unsigned int> v( 100, 0 );
+        for ( int i=0; i < 100; i += 3 )
+            v[i] = 5;
+        IntList il( v );
+
+        BOOST_CHECK( SparseIntList::density(il) == SparseIntList(il).density() );
+        BOOST_CHECK( !SparseIntList::should_be_sparse(il) );
+    }
+
+    {   //
+        // short values aren't worth the bother no matter how sparse they are
+        //
+        IntList il( 1000000000 );
+        BOOST_CHECK( !SparseIntList::should_be_sparse(il) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// SparseIntList::shifted
+// *******************************************************************************
+//
+// return this value multiplied by 10^k (which is just a change of offsets).
+//
+// *******************************************************************************
+//
+SparseIntList SparseIntList::shifted( unsigned long k ) const
+{
+    auto blks = blocks;
+    for ( auto& b : blks )
+        b.offset += k;
+    return SparseIntList( std::move(blks) );
+}
+
+
+
+// *******************************************************************************
+// SparseIntList::digit_at
+// *******************************************************************************
+//
+// return the digit at the specified power of 10.
+//
+// *******************************************************************************
+//
+SparseIntList::value_type SparseIntList::digit_at( unsigned long pos ) const
+{
+    auto b = std::upper_bound( blocks.begin(), blocks.end(), pos,
+                               [](unsigned long p, const block& b) { return p < b.offset; } );
+    if (b == blocks.begin())
+        return 0;
+    --b;
+    return pos < b->end() ? b->digits[ b->digits.size() - 1 - (pos - b->offset) ] : 0;
+}
+
+
+
+// *******************************************************************************
+// SparseIntList operator <=>
+// *******************************************************************************
+//
+// compare as numbers: longer is bigger; otherwise compare from the msd down,
+// only looking at digits that sit in a block of either value.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+std::strong_ordering SparseIntList::operator<=>(const SparseIntList& that) const
+{
+    if (num_digits != that.num_digits)
+        return num_digits <=> that.num_digits;
+
+    auto spans = merged_spans( blocks, that.blocks );
+    for ( auto s = spans.rbegin(); s != spans.rend(); ++s )
+        for ( auto pos = s->second; pos-- > s->first; ) {
+            auto c = digit_at(pos) <=> that.digit_at(pos);
+            if (c != 0)
+                return c;
+        }
+    return std::strong_ordering::equal;
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_comparison_operator_tests)
+{
+    SparseIntList a( IntList {1,0,0,0,0,0,0,0,0,0,0,0,5} );
+    SparseIntList b( IntList {1,0,0,0,0,0,0,0,0,0,0,0,6} );
+    SparseIntList c( IntList {9,9,9,9,9} );
+
+    BOOST_CHECK( a < b );
+    BOOST_CHECK( b > a );
+    BOOST_CHECK( c < a );
+    BOOST_CHECK( a == a.clone() );
+    BOOST_CHECK( a != b );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// SparseIntList addition operator (+)
+// *******************************************************************************
+//
+// Add two sparse values, only visiting the digit ranges covered by a block of
+// either summand. A carry out of a range lands on a digit that is zero in both
+// summands, so it stops right there.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+SparseIntList operator+(const SparseIntList& a, const SparseIntList& b)
+{
+    SparseIntList::builder sum;
+    block_cursor ac( a.blocks );
+    block_cursor bc( b.blocks );
+
+    for ( auto [lo, hi] : merged_spans( a.blocks, b.blocks ) ) {
+        unsigned int carry = 0;
+        for ( auto pos = lo; pos < hi; ++pos ) {
+            auto digit_sum = ac.at(pos) + bc.at(pos) + carry;
+            sum.put( pos, digit_sum%10 );
+            carry = digit_sum/10;
+        }
+        sum.put( hi, carry );
+    }
+
+    return SparseIntList( sum.finish() );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_addition_operator_tests)
+{
+    {   //
+        // carries that ripple through a block and out into the gap
+        //
+        SparseIntList a( IntList {9,0,0,0,0,0,0,0,0,0,0,9,9,9} );
+        SparseIntList b( IntList {1} );
+        SparseIntList a_plus_b( IntList {9,0,0,0,0,0,0,0,0,0,1,0,0,0} );
+        BOOST_CHECK( a + b == a_plus_b );
+        BOOST_CHECK( (a + b).to_str() == "90000000001000" );
+    }
+
+    {   //
+        // carry into the msd
+        //
+        SparseIntList a( IntList {9,9,0,0,0,0,0,0,0,0,0,0} );
+        SparseIntList b( IntList {1,0,0,0,0,0,0,0,0,0,0} );
+        BOOST_CHECK( (a + b).to_str() == "1000000000000" );
+    }
+
+    {   //
+        // zero is the identity
+        //
+        SparseIntList a( IntList {4,0,0,0,0,0,0,0,0,0,0,0,2} );
+        SparseIntList z( IntList(0) );
+        BOOST_CHECK( a + z == a );
+        BOOST_CHECK( z + a == a );
+        BOOST_CHECK( (z + z).to_str() == "0" );
+    }
+
+    {   //
+        // compare against dense addition
+        //
+        for ( int i=0; i < 500; i++ ) {
+            std::vector<unsigned int> va( 1 + std::rand() % 120, 0 );
+            std::vector<unsigned int> vb( 1 + std::rand() % 120, 0 );
+            for ( int j = std::rand() % 12; j > 0; --j ) va[ std::rand() % va.size() ] = std::rand() % 10;
+            for ( int j = std::rand() % 12; j > 0; --j ) vb[ std::rand() % vb.size() ] = std::rand() % 10;
+
+            IntList da( va );
+            IntList db( vb );
+
+            BOOST_CHECK( (SparseIntList(da) + SparseIntList(db)).to_int_list() == da + db );
+        }
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// SparseIntList subtraction operator (-)
+// *******************************************************************************
+//
+// Subtract the second sparse value from the first (which must be >= to it). A
+// borrow out of a range has to cross the zero gap above it, turning the whole
+// gap into 9s until the next range of 'a' pays it back.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+SparseIntList operator-(const SparseIntList& a, const SparseIntList& b)
+{   //
+    // make sure a>=b
+    //
+    if (!(a >= b)) {
+        std::stringstream error_msg_ss;
+        error_msg_ss << "a (" << a.to_str() << ") must be >= (" << b.to_str() << ")";
+        throw std::invalid_argument(error_msg_ss.str());
+    }
+
+    SparseIntList::builder diff;
+    block_cursor ac( a.blocks );
+    block_cursor bc( b.blocks );
+
+    auto spans = merged_spans( a.blocks, b.blocks );
+    int borrow = 0;
+
+    for ( std::size_t s = 0; s < spans.size(); ++s ) {
+        auto [lo, hi] = spans[s];
+        for ( auto pos = lo; pos < hi; ++pos ) {
+            int d = int( ac.at(pos) ) - int( bc.at(pos) ) - borrow;
+            borrow = d < 0;
+            diff.put( pos, d + (borrow ? 10 : 0) );
+        }
+        if (borrow && s+1 < spans.size())
+            for ( auto pos = hi; pos < spans[s+1].first; ++pos )
+                diff.put( pos, 9 );
+    }
+
+    return SparseIntList( diff.finish() );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(sparseintlist_subtraction_operator_tests)
+{
+    {   //
+        // make sure that invalid inputs are rejected
+        //
+        SparseIntList a( IntList(998) );
+        SparseIntList b( IntList(999) );
+        BOOST_CHECK_THROW( a - b, std::invalid_argument );
+    }
+
+    {   //
+        // borrow across a long gap
+        //
+        SparseIntList a( IntList {1,0,0,0,0,0,0,0,0,0,0,0,0} );
+        SparseIntList b( IntList {1} );
+        BOOST_CHECK( (a - b).to_str() == "999999999999" );
+    }
+
+    {   //
+        // x - x == 0
+        //
+        SparseIntList a( IntList {3,0,0,0,0,0,0,0,0,0,0,0,0,1} );
+        BOOST_CHECK( (a - a).to_str() == "0" );
+    }
+
+    {   //
+        // compare against dense subtraction
+        //
+        for ( int i=0; i < 500; i++ ) {
+            std::vector<unsigned int> va( 1 + std::rand() % 120, 0 );
+            std::vector<unsigned int> vb( 1 + std::rand() % 120, 0 );
+            for ( int j = std::rand() % 12; j > 0; --j ) va[ std::rand() % va.size() ] = std::rand() % 10;
+            for ( int j = std::rand() % 12; j > 0; --j ) vb[ std::rand() % vb.size() ] = std::rand() % 10;
+
+            IntList da( va );
+            IntList db( vb );
+            if (da < db)
+                std::swap( da, db );
+
+            BOOST_CHECK( (SparseIntList(da) - SparseIntList(db)).to_int_list() == da - db );
+        }
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
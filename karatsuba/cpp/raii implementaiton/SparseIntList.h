@@ -0,0 +1,108 @@
+//
+// SparseIntList.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class declaration for sparse integer list type (using RAII patterns)
+// (ex: 7000000000000000042 is stored as the blocks [7] and [4,2], with the
+// zeros between them implied by the blocks' offsets)
+//
+#ifndef __sparse_int_list_h
+#define __sparse_int_list_h
+
+#include <vector>
+#include <string>
+#include <compare>
+
+#include "IntList.h"
+
+class SparseIntList
+//
+// A non-negative integer stored as a list of non-zero digit blocks separated
+// by runs of zeros
+//
+{
+public:
+    using value_type = IntList::value_type;
+
+    // a run of digits, stored msd-first like IntList, that starts and ends with a
+    // non-zero digit; 'offset' is the power of 10 of the block's lsd.
+    struct block {
+        unsigned long offset;
+        std::vector<value_type> digits;
+
+        unsigned long end() const { return offset + digits.size(); }
+        bool operator==(const block&) const = default;
+    };
+
+    // zero runs shorter than this are cheaper to keep inside their block
+    static const unsigned long min_zero_run = 8;
+
+    // an IntList at least 'min_sparse_size' digits long whose non-zero blocks
+    // cover no more than 'density_threshold' of its digits is worth converting
+    static constexpr double density_threshold = 0.5;
+    static const unsigned long min_sparse_size = 64;
+
+private:
+    // sparse implementation (lsd block first)
+    std::vector<block> blocks;
+    unsigned long num_digits;
+
+    // accumulates lsd-first digits into blocks
+    class builder;
+
+    SparseIntList( std::vector<block>&& blocks );
+
+    // digit at the specified power of 10 (0 if it falls between blocks)
+    value_type digit_at( unsigned long pos ) const;
+
+public:
+    // constructors
+    explicit SparseIntList( const IntList& il ); // init by (dense) integer list
+
+    // copy & move semantics / construction
+    SparseIntList( const SparseIntList& ) = delete; // no copy constructor!
+    SparseIntList( SparseIntList&& ) = default;     // yes move constructor
+
+    // copy & move semantics / operators
+    SparseIntList& operator=(const SparseIntList&) = delete; // no copy operator!
+    SparseIntList& operator=(SparseIntList&&) = default;     // move operator
+
+    // in lieu of copy constructor
+    SparseIntList clone() const;
+
+    // conversion back to the dense representation
+    IntList to_int_list() const;
+
+    // generate string representation
+    std::string to_str() const;
+
+    // number of digits in the value (as IntList::size() would report it)
+    unsigned long size() const { return num_digits; }
+
+    // number of digits actually held in blocks, and that as a fraction of size()
+    unsigned long stored_digits() const;
+    double density() const;
+
+    const std::vector<block>& get_blocks() const { return blocks; }
+
+    // the same value multiplied by 10^k
+    SparseIntList shifted( unsigned long k ) const;
+
+    // density that a sparse version of 'il' would have, and whether it is low
+    // enough to bother converting
+    static double density( const IntList& il );
+    static bool should_be_sparse( const IntList& il );
+
+    // numeric comparison
+    std::strong_ordering operator<=>(const SparseIntList& that) const;
+    bool operator==(const SparseIntList& that) const { return blocks == that.blocks; }
+
+    friend SparseIntList operator+(const SparseIntList& a, const SparseIntList& b);
+    friend SparseIntList operator-(const SparseIntList& a, const SparseIntList& b);
+};
+
+SparseIntList operator+(const SparseIntList& a, const SparseIntList& b);
+SparseIntList operator-(const SparseIntList& a, const SparseIntList& b);
+
+#endif // __sparse_int_list_h
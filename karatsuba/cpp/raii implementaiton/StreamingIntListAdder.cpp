@@ -0,0 +1,259 @@
+//
+// StreamingIntListAdder.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// class definitions for a streaming integer list adder/subtractor (using RAII
+// patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -DBUILD_STREAMINGINTLISTADDER_UNIT_TEST_RUNNER IntList.cpp StreamingIntListAdder.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_STREAMINGINTLISTADDER_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE StreamingIntListAdder Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_STREAMINGINTLISTADDER_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#include "StreamingIntListAdder.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+
+
+// ===============================================================================
+// class StreamingIntListAdder constructors
+// ===============================================================================
+
+StreamingIntListAdder::StreamingIntListAdder( sink_type sink, op which )
+    : sink( std::move(sink) ), which( which )
+{
+    if ( !this->sink )
+        throw std::invalid_argument( "a streaming adder needs somewhere to send its result" );
+}
+
+
+
+// ===============================================================================
+// class StreamingIntListAdder methods
+// ===============================================================================
+
+// *******************************************************************************
+// StreamingIntListAdder::push
+// *******************************************************************************
+//
+// Every digit of a sum (or difference) is final as soon as the carry into it
+// is known, which in lsd-first order it always is; only the carry out of the
+// top is left over. So each chunk goes straight back out, except for any run
+// of zeros at its top: those are held (as a count) until a non-zero digit
+// shows up above them, since if none ever does they were leading zeros.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void StreamingIntListAdder::push( std::span<const value_type> a_chunk, std::span<const value_type> b_chunk )
+{
+    if ( finished )
+        throw std::logic_error( "can't push to a streaming adder after finish()" );
+
+    if ( !a_chunk.empty() && !b_chunk.empty() && a_chunk.size() != b_chunk.size() )
+        throw std::invalid_argument( "chunks must be the same length (" + std::to_string(a_chunk.size()) +
+                                     " != " + std::to_string(b_chunk.size()) + ")" );
+
+    // check everything before touching any state
+    for ( auto chunk : { a_chunk, b_chunk } )
+        for ( auto d : chunk )
+            if ( d > IntList::upper_bound )
+                throw std::invalid_argument( "value " + std::to_string(d) + " is out of range [" +
+                                             std::to_string(IntList::lower_bound) + ", " +
+                                             std::to_string(IntList::upper_bound) + "]" );
+
+    const std::size_t n = std::max( a_chunk.size(), b_chunk.size() );
+    out.resize( n );
+
+    std::size_t top = 0;    // one past the highest non-zero digit of this chunk
+    for ( std::size_t i = 0; i < n; ++i ) {
+        int a = i < a_chunk.size() ? int( a_chunk[i] ) : 0;
+        int b = i < b_chunk.size() ? int( b_chunk[i] ) : 0;
+        int d;
+        if ( which == op::add ) {
+            d = a + b + carry;
+            carry = d >= 10;
+            d -= carry ? 10 : 0;
+        }
+        else {
+            d = a - b - int(carry);
+            carry = d < 0;
+            d += carry ? 10 : 0;
+        }
+        out[i] = d;
+        if ( d != 0 )
+            top = i + 1;
+    }
+
+    if ( top > 0 ) {
+        emit_pending_zeros();
+        sink( std::span<const value_type>( out.data(), top ) );
+        emitted += top;
+    }
+    pending_zeros += n - top;
+}
+
+
+
+// *******************************************************************************
+// StreamingIntListAdder::finish
+// *******************************************************************************
+//
+unsigned long StreamingIntListAdder::finish()
+{
+    if ( finished )
+        throw std::logic_error( "streaming adder was already finished" );
+    finished = true;
+
+    if ( carry != 0 ) {
+        if ( which == op::subtract )
+            throw std::invalid_argument( "a must be >= b" );
+
+        const value_type one = 1;
+        emit_pending_zeros();
+        sink( std::span<const value_type>( &one, 1 ) );
+        emitted += 1;
+    }
+
+    if ( emitted == 0 ) {   // the whole result was zero
+        const value_type zero = 0;
+        sink( std::span<const value_type>( &zero, 1 ) );
+        emitted = 1;
+    }
+
+    return emitted;
+}
+
+
+
+// *******************************************************************************
+// StreamingIntListAdder::emit_pending_zeros
+// *******************************************************************************
+//
+// (a bounded buffer's worth at a time, however long the run was)
+//
+void StreamingIntListAdder::emit_pending_zeros()
+{
+    static const std::array<value_type, 4096> zeros {};
+
+    while ( pending_zeros > 0 ) {
+        auto n = std::min<unsigned long>( pending_zeros, zeros.size() );
+        sink( std::span<const value_type>( zeros.data(), n ) );
+        emitted += n;
+        pending_zeros -= n;
+    }
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+
+// feed a and b through a streaming adder in random-sized chunks, and put the
+// result back together as an IntList
+static IntList stream_through( const IntList& a, const IntList& b, StreamingIntListAdder::op which,
+                               std::size_t max_chunk )
+{
+    std::vector<IntList::value_type> result;  // lsd first
+    StreamingIntListAdder adder( [&]( auto chunk ) { result.insert( result.end(), chunk.begin(), chunk.end() ); },
+                                 which );
+
+    std::vector<IntList::value_type> a_lsd( a.crbegin(), a.crend() );
+    std::vector<IntList::value_type> b_lsd( b.crbegin(), b.crend() );
+    std::span<const IntList::value_type> a_rest( a_lsd ), b_rest( b_lsd );
+
+    while ( !a_rest.empty() || !b_rest.empty() ) {
+        auto n = 1 + std::rand() % max_chunk;
+        auto a_n = std::min( n, a_rest.size() );
+        auto b_n = std::min( n, b_rest.size() );
+        if ( a_n != 0 && b_n != 0 )
+            a_n = b_n = std::min( a_n, b_n );
+
+        adder.push( a_rest.first(a_n), b_rest.first(b_n) );
+        a_rest = a_rest.subspan( a_n );
+        b_rest = b_rest.subspan( b_n );
+    }
+
+    auto length = adder.finish();
+    BOOST_CHECK( length == result.size() );
+
+    std::reverse( result.begin(), result.end() );
+    return IntList( std::move(result) );
+}
+
+BOOST_AUTO_TEST_CASE(streamingintlistadder_tests)
+{
+    using op = StreamingIntListAdder::op;
+
+    {   //
+        // double-checking random values against the in-memory operators
+        //
+        std::srand(time(nullptr));
+
+        for ( int i=0; i < 300; i++ ) {
+            auto x = random_int_list( 1 + std::rand() % 500 );
+            auto y = random_int_list( 1 + std::rand() % 500 );
+            if ( x < y )
+                std::swap( x, y );
+            std::size_t max_chunk = 1 + std::rand() % 64;
+
+            BOOST_CHECK( stream_through( x, y, op::add, max_chunk ) == x + y );
+            BOOST_CHECK( stream_through( y, x, op::add, max_chunk ) == x + y );
+            BOOST_CHECK( stream_through( x, y, op::subtract, max_chunk ) == x - y );
+        }
+    }
+
+    {   //
+        // carries out the top, and results with (lots of) leading zeros
+        //
+        std::vector<IntList::value_type> nines( 10000, 9 );
+        IntList big( nines );
+        BOOST_CHECK( stream_through( big, IntList(1), op::add, 100 ) == big + IntList(1) );
+        BOOST_CHECK( stream_through( big, big, op::subtract, 100 ) == IntList(0) );
+        BOOST_CHECK( stream_through( big, IntList(9), op::subtract, 7 ) == big - IntList(9) );
+        BOOST_CHECK( stream_through( IntList(0), IntList(0), op::add, 1 ) == IntList(0) );
+    }
+
+    {   //
+        // bad input
+        //
+        auto ignore = []( auto ){};
+        BOOST_CHECK_THROW( stream_through( IntList(5), IntList(6), op::subtract, 1 ), std::invalid_argument );
+
+        StreamingIntListAdder adder( ignore );
+        std::vector<IntList::value_type> two {1,2}, three {1,2,3}, bad {1,10};
+        BOOST_CHECK_THROW( adder.push( two, three ), std::invalid_argument );
+        BOOST_CHECK_THROW( adder.push( bad, two ), std::invalid_argument );
+        BOOST_CHECK_NO_THROW( adder.push( two, {} ) );
+        BOOST_CHECK( adder.finish() == 2 );
+        BOOST_CHECK_THROW( adder.push( two, two ), std::logic_error );
+        BOOST_CHECK_THROW( adder.finish(), std::logic_error );
+
+        BOOST_CHECK_THROW( StreamingIntListAdder( nullptr ), std::invalid_argument );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
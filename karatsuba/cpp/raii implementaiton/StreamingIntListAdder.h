@@ -0,0 +1,65 @@
+//
+// StreamingIntListAdder.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class declaration for a streaming integer list adder/subtractor (using RAII
+// patterns); numbers come in as chunks of digits, lsd first, and the result
+// goes out the same way as soon as it's final, so no whole number is ever held.
+//
+#ifndef __streaming_int_list_adder_h
+#define __streaming_int_list_adder_h
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "IntList.h"
+
+class StreamingIntListAdder
+//
+// a + b (or a - b), fed a chunk of each at a time
+//
+{
+public:
+    using value_type = IntList::value_type;
+
+    // receives the result in chunks, lsd first (chunk[0] is the lowest digit)
+    using sink_type = std::function<void( std::span<const value_type> )>;
+
+    enum class op { add, subtract };
+
+private:
+    sink_type sink;
+    op which;
+
+    unsigned int carry = 0;             // carry (add) or borrow (subtract) into the next digit
+    unsigned long pending_zeros = 0;    // zeros computed but not sent yet; they'd be leading
+                                        // zeros if nothing but zeros follows them
+    unsigned long emitted = 0;          // digits sent so far
+    bool finished = false;
+
+    std::vector<value_type> out;        // reused output buffer, as big as the biggest chunk
+
+    void emit_pending_zeros();
+
+public:
+    // constructors
+    explicit StreamingIntListAdder( sink_type sink, op which = op::add );
+
+    // copy & move semantics / construction
+    StreamingIntListAdder( const StreamingIntListAdder& ) = delete;
+    StreamingIntListAdder( StreamingIntListAdder&& ) = default;
+    StreamingIntListAdder& operator=( const StreamingIntListAdder& ) = delete;
+    StreamingIntListAdder& operator=( StreamingIntListAdder&& ) = default;
+
+    // the next digits of a and b (lsd first, at the same powers of 10); once
+    // one operand has run out, pass an empty chunk for it
+    void push( std::span<const value_type> a_chunk, std::span<const value_type> b_chunk );
+
+    // no more chunks; send off what's left and return the result's length in
+    // digits. Throws std::invalid_argument if a subtraction came out negative.
+    unsigned long finish();
+};
+
+#endif // __streaming_int_list_adder_h
@@ -0,0 +1,345 @@
+//
+// WorkStealingPool.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// class definitions for a work-stealing thread pool (using RAII patterns)
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_WORKSTEALINGPOOL_UNIT_TEST_RUNNER WorkStealingPool.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_WORKSTEALINGPOOL_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE WorkStealingPool Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_WORKSTEALINGPOOL_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+#include "WorkStealingPool.h"
+
+// which pool (if any) the current thread works for, and its queue there
+static thread_local const WorkStealingPool* this_thread_pool = nullptr;
+static thread_local int this_thread_index = -1;
+
+
+
+// ===============================================================================
+// class WorkStealingPool constructors
+// ===============================================================================
+
+// *******************************************************************************
+// WorkStealingPool::WorkStealingPool / WorkStealingPool::~WorkStealingPool
+// *******************************************************************************
+//
+// start the workers; on the way out, wake them all up, tell them to stop, and
+// wait for them.
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+WorkStealingPool::WorkStealingPool( unsigned int threads )
+{
+    if (threads == 0)
+        throw std::invalid_argument( "a pool needs at least one thread" );
+
+    for ( unsigned int i=0; i <= threads; i++ )
+        queues.push_back( std::make_unique<task_queue>() );
+
+    for ( unsigned int i=0; i < threads; i++ )
+        workers.emplace_back( [this, i]{ worker_loop(i); } );
+}
+//
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard( sleep_lock );
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for ( auto& w : workers )
+        w.join();
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE(workstealingpool_construction_tests)
+{
+    BOOST_CHECK_THROW( WorkStealingPool pool(0), std::invalid_argument );
+
+    {   //
+        // pools come and go without leaving anything behind
+        //
+        WorkStealingPool pool(4);
+        BOOST_CHECK( pool.size() == 4 );
+    }
+
+    BOOST_CHECK( WorkStealingPool::shared().size() >= 1 );
+    BOOST_CHECK( &WorkStealingPool::shared() == &WorkStealingPool::shared() );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// WorkStealingPool::shared
+// *******************************************************************************
+//
+// the pool everything uses unless told otherwise; constructed (and its threads
+// started) the first time anybody asks for it.
+//
+// *******************************************************************************
+//
+WorkStealingPool& WorkStealingPool::shared()
+{
+    static WorkStealingPool pool( std::max( 1u, std::thread::hardware_concurrency() ) );
+    return pool;
+}
+
+
+
+// ===============================================================================
+// class WorkStealingPool methods
+// ===============================================================================
+
+// *******************************************************************************
+// WorkStealingPool::current_index
+// *******************************************************************************
+//
+int WorkStealingPool::current_index() const
+{
+    return this_thread_pool == this ? this_thread_index : -1;
+}
+
+
+
+// *******************************************************************************
+// WorkStealingPool::push
+// *******************************************************************************
+//
+// workers push onto their own deque; everybody else shares the last one. Then
+// make sure at least one sleeping worker hears about it; when none are asleep
+// (the usual case in the middle of a recursion) that costs nothing but a load,
+// so forks don't all queue up on the one sleep_lock.
+//
+// *******************************************************************************
+//
+void WorkStealingPool::push( task t )
+{
+    auto index = current_index();
+    auto& q = *queues[ index >= 0 ? index : queues.size()-1 ];
+    {
+        std::lock_guard<std::mutex> guard( q.lock );
+        q.tasks.push_back( std::move(t) );
+    }
+    //
+    // (sequentially consistent, both: a worker going to sleep counts itself
+    // in 'sleeping' before it looks at 'queued' one last time, so either it
+    // sees this task or we see it)
+    //
+    queued.fetch_add( 1 );
+    if ( sleeping.load() == 0 )
+        return;
+
+    std::lock_guard<std::mutex> guard( sleep_lock ); // (so a worker that just saw
+    wake.notify_one();                               // an empty pool can't miss this)
+}
+
+
+
+// *******************************************************************************
+// WorkStealingPool::try_run_one
+// *******************************************************************************
+//
+// Pop the newest task off our own deque if we're a worker; otherwise pick a
+// random victim and walk the deques from there, stealing the oldest task from
+// the first non-empty one. Runs the task and reports whether there was one.
+//
+// *******************************************************************************
+//
+bool WorkStealingPool::try_run_one()
+{
+    if ( queued.load( std::memory_order_acquire ) == 0 )
+        return false;
+
+    task t;
+    auto index = current_index();
+
+    if ( index >= 0 ) {
+        auto& q = *queues[index];
+        std::lock_guard<std::mutex> guard( q.lock );
+        if ( !q.tasks.empty() ) {
+            t = std::move( q.tasks.back() );
+            q.tasks.pop_back();
+        }
+    }
+
+    if ( !t ) {
+        static thread_local std::minstd_rand rng( std::random_device{}() );
+        auto start = rng() % queues.size();
+
+        for ( std::size_t n = 0; n < queues.size() && !t; ++n ) {
+            auto& q = *queues[ (start + n) % queues.size() ];
+            std::lock_guard<std::mutex> guard( q.lock );
+            if ( !q.tasks.empty() ) {
+                t = std::move( q.tasks.front() );
+                q.tasks.pop_front();
+            }
+        }
+    }
+
+    if ( !t )
+        return false;
+
+    queued.fetch_sub( 1, std::memory_order_acq_rel );
+    t();
+    return true;
+}
+
+
+
+// *******************************************************************************
+// WorkStealingPool::worker_loop
+// *******************************************************************************
+//
+// run tasks until there aren't any, then sleep until more show up (or we're
+// told to stop).
+//
+// *******************************************************************************
+//
+void WorkStealingPool::worker_loop( unsigned int index )
+{
+    this_thread_pool = this;
+    this_thread_index = index;
+
+    while ( !stopping ) {
+        if ( try_run_one() )
+            continue;
+
+        std::unique_lock<std::mutex> guard( sleep_lock );
+        ++sleeping;
+        wake.wait( guard, [this]{ return stopping || queued.load() > 0; } );
+        --sleeping;
+    }
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+static unsigned long fib( WorkStealingPool& pool, unsigned int n )
+{   //
+    // the classic fork/join stress: lots of tiny nested tasks
+    //
+    if (n < 2)
+        return n;
+    auto f1 = pool.fork( [&pool, n]{ return fib( pool, n-1 ); } );
+    auto f2 = fib( pool, n-2 );
+    return pool.join( f1 ) + f2;
+}
+
+BOOST_AUTO_TEST_CASE(workstealingpool_fork_join_tests)
+{
+    {   //
+        // simple independent tasks
+        //
+        WorkStealingPool pool(4);
+        std::vector<WorkStealingPool::task_handle<int>> handles;
+        for ( int i=0; i < 1000; i++ )
+            handles.push_back( pool.fork( [i]{ return i*i; } ) );
+
+        bool all_good = true;
+        for ( int i=0; i < 1000; i++ )
+            all_good &= pool.join( handles[i] ) == i*i;
+        BOOST_CHECK( all_good );
+    }
+
+    {   //
+        // nested forks, from the outside and from the workers themselves
+        //
+        WorkStealingPool pool(3);
+        BOOST_CHECK( fib( pool, 20 ) == 6765 );
+    }
+
+    {   //
+        // void tasks and exceptions
+        //
+        WorkStealingPool pool(2);
+        std::atomic<int> count {0};
+        auto v = pool.fork( [&]{ ++count; } );
+        pool.join( v );
+        BOOST_CHECK( count == 1 );
+
+        auto e = pool.fork( []() -> int { throw std::runtime_error("boom"); } );
+        BOOST_CHECK_THROW( pool.join( e ), std::runtime_error );
+    }
+
+    {   //
+        // waiting (to unwind safely) finishes the task but leaves its result,
+        // or its exception, for a join
+        //
+        WorkStealingPool pool(2);
+        std::atomic<int> count {0};
+        auto slow = pool.fork( [&]{
+            std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+            return ++count;
+        } );
+        auto e = pool.fork( []() -> int { throw std::runtime_error("boom"); } );
+
+        pool.wait( slow );
+        pool.wait( e );
+        BOOST_CHECK( slow.ready() && count == 1 );
+        BOOST_CHECK( pool.join( slow ) == 1 );
+        BOOST_CHECK_THROW( pool.join( e ), std::runtime_error );
+    }
+
+    {   //
+        // a task forked onto an idle pool wakes a worker up to run it (nobody
+        // joins here, so nobody else would)
+        //
+        WorkStealingPool pool(2);
+        bool all_ran = true;
+        for ( int i=0; i < 20; i++ ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );    // (let them doze off)
+            auto t = pool.fork( [i]{ return i; } );
+            for ( int wait=0; wait < 5000 && !t.ready(); wait++ )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            all_ran &= t.ready();
+        }
+        BOOST_CHECK( all_ran );
+    }
+
+    {   //
+        // several outside threads sharing one pool at the same time
+        //
+        WorkStealingPool pool(2);
+        std::vector<unsigned long> results( 4 );
+        std::vector<std::thread> callers;
+        for ( int i=0; i < 4; i++ )
+            callers.emplace_back( [&, i]{ results[i] = fib( pool, 15 ); } );
+        for ( auto& c : callers )
+            c.join();
+
+        BOOST_CHECK( std::all_of( results.begin(), results.end(), [](auto r){ return r == 610; } ) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
@@ -0,0 +1,168 @@
+//
+// WorkStealingPool.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// class declaration for a work-stealing thread pool (using RAII patterns); the
+// arithmetic routines fork fine-grained tasks onto it and help run other
+// tasks while they wait to join them.
+//
+#ifndef __work_stealing_pool_h
+#define __work_stealing_pool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+class WorkStealingPool
+//
+// A fixed set of worker threads, each with its own task deque. Workers push and
+// pop their own tasks at the back (newest first, which keeps a recursion's
+// working set hot) and, when they run dry, steal from the front (oldest, and so
+// usually biggest) of a randomly chosen victim's deque.
+//
+{
+public:
+    // a forked task's eventual result
+    template<typename T> class task_handle;
+
+private:
+    using task = std::function<void()>;
+
+    struct task_queue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    // one queue per worker, plus a last one for tasks forked from threads that
+    // aren't workers of this pool
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<long> queued {0};
+    std::atomic<bool> stopping {false};
+    std::atomic<unsigned int> sleeping {0};     // workers waiting on 'wake' (or about to)
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+
+    int current_index() const;      // calling thread's worker index (or -1)
+    void push( task t );
+    bool try_run_one();             // run one queued task; false if none found
+    void worker_loop( unsigned int index );
+
+public:
+    // constructors
+    explicit WorkStealingPool( unsigned int threads );
+    ~WorkStealingPool();
+
+    // copy & move semantics (the workers hold 'this', so neither)
+    WorkStealingPool( const WorkStealingPool& ) = delete;
+    WorkStealingPool& operator=( const WorkStealingPool& ) = delete;
+
+    unsigned int size() const { return workers.size(); }
+
+    // process-wide pool (one worker per hardware thread), started on first use
+    static WorkStealingPool& shared();
+
+    // queue f to run on the pool
+    template<typename F>
+    task_handle<std::invoke_result_t<F&>> fork( F&& f );
+
+    // wait for a forked task (running other queued tasks in the meantime) and
+    // return its result, or rethrow whatever it threw
+    template<typename T>
+    T join( task_handle<T>& h );
+
+    // wait for a forked task the same way, but leave its result (or whatever
+    // it threw) where it is: for unwinding past tasks that still refer to
+    // the caller's locals
+    template<typename T>
+    void wait( const task_handle<T>& h );
+};
+
+
+
+// *******************************************************************************
+// WorkStealingPool::task_handle
+// *******************************************************************************
+//
+template<typename T>
+class WorkStealingPool::task_handle
+{
+    friend class WorkStealingPool;
+
+    using value_t = std::conditional_t< std::is_void_v<T>, std::monostate, T >;
+
+    struct state {
+        std::atomic<bool> done {false};
+        std::optional<value_t> value;
+        std::exception_ptr error;
+    };
+    std::shared_ptr<state> st = std::make_shared<state>();
+
+public:
+    bool ready() const { return st->done.load( std::memory_order_acquire ); }
+};
+
+
+
+// *******************************************************************************
+// WorkStealingPool::fork / WorkStealingPool::join / WorkStealingPool::wait
+// *******************************************************************************
+//
+template<typename F>
+WorkStealingPool::task_handle<std::invoke_result_t<F&>> WorkStealingPool::fork( F&& f )
+{
+    using T = std::invoke_result_t<F&>;
+
+    task_handle<T> h;
+    push( [st = h.st, f = std::forward<F>(f)]() mutable {
+        try {
+            if constexpr ( std::is_void_v<T> ) {
+                f();
+                st->value.emplace();
+            }
+            else
+                st->value.emplace( f() );
+        }
+        catch (...) {
+            st->error = std::current_exception();
+        }
+        st->done.store( true, std::memory_order_release );
+    } );
+    return h;
+}
+
+template<typename T>
+T WorkStealingPool::join( task_handle<T>& h )
+{
+    while ( !h.ready() )
+        if ( !try_run_one() )
+            std::this_thread::yield();  // it's running somewhere else; let it
+
+    if ( h.st->error )
+        std::rethrow_exception( h.st->error );
+
+    if constexpr ( !std::is_void_v<T> )
+        return std::move( *h.st->value );
+}
+
+template<typename T>
+void WorkStealingPool::wait( const task_handle<T>& h )
+{
+    while ( !h.ready() )
+        if ( !try_run_one() )
+            std::this_thread::yield();
+}
+
+#endif // __work_stealing_pool_h
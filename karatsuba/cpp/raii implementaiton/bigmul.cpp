@@ -0,0 +1,498 @@
+//
+// bigmul.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// Command-line driver for Karatsuba multiplication: multiplies two decimal
+// numbers from files (or stdin) and writes the product to stdout (or a file),
+// or (with --batch) a whole file of pairs, one per line; or (with --serve)
+// runs as a server other processes on the host send their pairs to.
+//
+// NOTE: build with:
+// g++-11 -std=c++2a -O2 -pthread -o bigmul IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp IntListIO.cpp karatsuba.cpp karatsuba_out_of_core.cpp MultiplyPipeline.cpp MultiplyServer.cpp bigmul.cpp
+//
+// and run 'bigmul --help' for the options.
+//
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "IntList.h"
+#include "IntListIO.h"
+#include "IntListParallel.h"
+#include "WorkStealingPool.h"
+#include "karatsuba.h"
+#include "karatsuba_out_of_core.h"
+#include "MultiplyPipeline.h"
+#include "MultiplyServer.h"
+
+#include <pthread.h>
+#include <signal.h>
+
+static const char* usage =
+    "usage: bigmul [options] [X_FILE [Y_FILE]]\n"
+    "       bigmul --batch [options] [PAIRS_FILE]\n"
+    "       bigmul --serve SOCKET [options]\n"
+    "\n"
+    "Multiply two non-negative decimal integers and print the product.\n"
+    "\n"
+    "Operands are read from X_FILE and Y_FILE, or from stdin (as two numbers\n"
+    "separated by whitespace) for any that are missing or given as '-'.\n"
+    "\n"
+    "With --batch, every line of PAIRS_FILE (or stdin) holds a pair 'X Y', and\n"
+    "the products are printed one per line in the same order; reading, the\n"
+    "multiplies and writing all run at once, on --threads multiply workers.\n"
+    "\n"
+    "With --serve, listen on the Unix domain socket SOCKET for multiply requests\n"
+    "(see MultiplyServer.h for the protocol, and bigmul_load for a client) until\n"
+    "interrupted, batching them onto one pool of --threads threads.\n"
+    "\n"
+    "options:\n"
+    "  -o, --output FILE      write the product to FILE instead of stdout\n"
+    "  -a, --algorithm NAME   karatsuba     sequential\n"
+    "                         parallel      forked onto a thread pool (default)\n"
+    "                         out-of-core   blocked through files, for operands\n"
+    "                                       bigger than memory (needs X_FILE,\n"
+    "                                       Y_FILE and --output)\n"
+    "  -t, --threads N        threads for parsing, multiplying and formatting\n"
+    "                         (default: one per hardware thread)\n"
+    "      --cutoff N         operand digits below which 'parallel' stops forking\n"
+    "      --memory MB        resident memory budget for 'out-of-core'\n"
+    "      --batch            multiply a file of pairs, one per line\n"
+    "      --serve SOCKET     multiply requests sent to SOCKET\n"
+    "      --queue N          pairs in flight at once in --batch, or requests\n"
+    "                         multiplied together by --serve (default 64)\n"
+    "      --stats            print per-phase (or per-stage) timings to stderr\n"
+    "  -h, --help             show this message\n";
+
+namespace {
+
+enum class algorithm { karatsuba, parallel, out_of_core };
+
+struct options
+{
+    std::vector<std::string> inputs;
+    std::optional<std::string> output;
+    algorithm algo = algorithm::parallel;
+    unsigned int threads = std::max( 1u, std::thread::hardware_concurrency() );
+    unsigned long cutoff = default_parallel_cutoff_digits;
+    std::size_t memory = default_out_of_core_rss_budget;
+    bool batch = false;
+    std::optional<std::string> serve;
+    std::size_t queue = default_pipeline_queue_depth;
+    bool stats = false;
+};
+
+options parse_command_line( int argc, char* argv[] )
+{
+    options opts;
+
+    for ( int i = 1; i < argc; ++i ) {
+        std::string_view arg = argv[i];
+
+        auto value = [&]() -> std::string_view {
+            if ( i+1 >= argc )
+                throw usage_error( std::string(arg) + " needs a value" );
+            return argv[++i];
+        };
+
+        if ( arg == "-h" || arg == "--help" ) {
+            std::cout << usage;
+            std::exit( 0 );
+        }
+        else if ( arg == "-o" || arg == "--output" )
+            opts.output = value();
+        else if ( arg == "-a" || arg == "--algorithm" ) {
+            auto name = value();
+            if      ( name == "karatsuba"   ) opts.algo = algorithm::karatsuba;
+            else if ( name == "parallel"    ) opts.algo = algorithm::parallel;
+            else if ( name == "out-of-core" ) opts.algo = algorithm::out_of_core;
+            else throw usage_error( "unknown algorithm '" + std::string(name) + "'" );
+        }
+        else if ( arg == "-t" || arg == "--threads" )
+            opts.threads = parse_count( arg, value() );
+        else if ( arg == "--cutoff" )
+            opts.cutoff = parse_count( arg, value() );
+        else if ( arg == "--memory" ) {
+            auto mb = parse_count( arg, value() );
+            if ( mb > ULONG_MAX >> 20 )
+                throw usage_error( std::string(arg) + " " + std::to_string(mb) + " is more than can be addressed" );
+            opts.memory = mb << 20;
+        }
+        else if ( arg == "--batch" )
+            opts.batch = true;
+        else if ( arg == "--serve" )
+            opts.serve = value();
+        else if ( arg == "--queue" )
+            opts.queue = parse_count( arg, value() );
+        else if ( arg == "--stats" )
+            opts.stats = true;
+        else if ( arg.size() > 1 && arg[0] == '-' )
+            throw usage_error( "unknown option '" + std::string(arg) + "'" );
+        else
+            opts.inputs.emplace_back( arg );
+    }
+
+    if ( opts.inputs.size() > 2 )
+        throw usage_error( "expected at most two operand files" );
+
+    if ( opts.batch && opts.inputs.size() > 1 )
+        throw usage_error( "--batch reads its pairs from one file" );
+    if ( opts.batch && opts.algo == algorithm::out_of_core )
+        throw usage_error( "--batch doesn't go with out-of-core" );
+    if ( opts.serve && (opts.batch || !opts.inputs.empty() || opts.output || opts.algo == algorithm::out_of_core) )
+        throw usage_error( "--serve takes no operands, --output, --batch or out-of-core" );
+
+    if ( opts.algo == algorithm::out_of_core &&
+         (opts.inputs.size() != 2 || opts.inputs[0] == "-" || opts.inputs[1] == "-" || !opts.output) )
+        throw usage_error( "out-of-core needs both operands as files, and --output" );
+
+    return opts;
+}
+
+
+
+// *******************************************************************************
+// phase timing for --stats
+// *******************************************************************************
+//
+class phase_timer
+{
+    using clock = std::chrono::steady_clock;
+
+    bool enabled;
+    clock::time_point start = clock::now();
+
+public:
+    explicit phase_timer( bool enabled ) : enabled( enabled ) {}
+
+    // report the time since the last call (or construction), and restart
+    void lap( const std::string& phase, const std::string& detail = "" )
+    {
+        auto now = clock::now();
+        if ( enabled )
+            std::fprintf( stderr, "%-10s %10.3f s   %s\n", phase.c_str(),
+                          std::chrono::duration<double>( now - start ).count(), detail.c_str() );
+        start = clock::now();
+    }
+};
+
+
+
+// *******************************************************************************
+// operand input
+// *******************************************************************************
+//
+// Files are mapped and parsed straight out of the mapping; stdin is slurped in
+// big reads and split at whitespace. Either way the digits are validated and
+// converted in parallel blocks on the pool.
+//
+// *******************************************************************************
+//
+std::string read_all_stdin()
+{
+    std::string text;
+    std::vector<char> buffer( 1 << 20 );
+    for ( std::size_t n; (n = std::fread( buffer.data(), 1, buffer.size(), stdin )) > 0; )
+        text.append( buffer.data(), n );
+    if ( std::ferror( stdin ) )
+        throw std::runtime_error( "can't read stdin" );
+    return text;
+}
+
+bool is_space( char c ) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+// next whitespace-separated token of 'text' (advancing past it)
+std::string_view next_token( std::string_view& text )
+{
+    while ( !text.empty() && is_space( text.front() ) )
+        text.remove_prefix( 1 );
+    auto end = std::find_if( text.begin(), text.end(), is_space ) - text.begin();
+    auto token = text.substr( 0, end );
+    text.remove_prefix( end );
+    return token;
+}
+
+IntList parse_operand( std::string_view text, const std::string& where, WorkStealingPool& pool )
+{
+    if ( text.empty() )
+        throw std::invalid_argument( where + ": missing operand" );
+    try {
+        return from_str_parallel( text, pool );
+    }
+    catch ( const std::invalid_argument& e ) {
+        throw std::invalid_argument( where + ": " + e.what() );
+    }
+}
+
+std::pair<IntList, IntList> read_operands( const options& opts, WorkStealingPool& pool )
+{
+    std::string stdin_text;
+    std::string_view stdin_rest;
+    bool stdin_read = false;
+
+    auto read = [&]( std::size_t i ) -> IntList {
+        if ( i < opts.inputs.size() && opts.inputs[i] != "-" ) {
+            MappedFile file( opts.inputs[i] );
+            auto text = file.view();
+            while ( !text.empty() && is_space( text.back() ) )
+                text.remove_suffix( 1 );
+            return parse_operand( text, opts.inputs[i], pool );
+        }
+
+        if ( !stdin_read ) {
+            stdin_text = read_all_stdin();
+            stdin_rest = stdin_text;
+            stdin_read = true;
+        }
+        return parse_operand( next_token( stdin_rest ), "stdin", pool );
+    };
+
+    auto x = read( 0 );
+    auto y = read( 1 );
+    return { std::move(x), std::move(y) };
+}
+
+
+
+// *******************************************************************************
+// product output
+// *******************************************************************************
+//
+// A file gets mapped and filled in parallel; stdout gets the digits formatted
+// a block at a time into one reused buffer and written out as they're ready.
+// Either way the digits end with a newline, like the products --batch writes.
+//
+// *******************************************************************************
+//
+void write_product( const IntList& product, const options& opts, WorkStealingPool& pool )
+{
+    if ( opts.output ) {
+        MappedFile file( *opts.output, product.size() + 1 );
+        write_chars_parallel( product, file.data(), pool );
+        file.data()[product.size()] = '\n';
+        return;
+    }
+
+    const unsigned long block = 1 << 20;
+    std::vector<char> buffer( std::min( block, product.size() ) + 1 );
+
+    for ( unsigned long first = 0; first < product.size(); first += block ) {
+        auto n = std::min( block, product.size() - first );
+        product.write_chars( buffer.data(), first, n );
+        if ( std::fwrite( buffer.data(), 1, n, stdout ) != n )
+            throw std::runtime_error( "can't write to stdout" );
+    }
+    if ( std::fputc( '\n', stdout ) == EOF || std::fflush( stdout ) != 0 )
+        throw std::runtime_error( "can't write to stdout" );
+}
+
+
+
+
+// *******************************************************************************
+// batch mode
+// *******************************************************************************
+//
+// The pairs file is mapped (or stdin slurped) and handed to the pipeline as it
+// is; the products go out through stdio, which does its own buffering.
+//
+// *******************************************************************************
+//
+void report_pipeline( const pipeline_stats& stats )
+{
+    std::fprintf( stderr, "%-12s %8s %10s %10s %12s\n", "stage", "items", "busy s", "wait s", "items/s" );
+
+    const pipeline_stage_stats* slowest = nullptr;
+    for ( auto& stage : stats.stages )
+        if ( !slowest || stage.throughput() < slowest->throughput() )
+            slowest = &stage;
+
+    for ( auto& stage : stats.stages ) {
+        auto name = stage.name + (stage.threads > 1 ? " x" + std::to_string( stage.threads ) : "");
+        std::fprintf( stderr, "%-12s %8lu %10.3f %10.3f %12.1f%s\n", name.c_str(), stage.items,
+                      stage.busy_seconds, stage.wait_seconds, stage.throughput(),
+                      &stage == slowest ? "   <- bottleneck" : "" );
+    }
+    std::fprintf( stderr, "%-12s %8lu %10.3f %10s %12.1f\n", "total", stats.pairs, stats.wall_seconds, "",
+                  stats.wall_seconds > 0 ? stats.pairs / stats.wall_seconds : 0.0 );
+}
+
+void run_batch( const options& opts )
+{
+    std::optional<MappedFile> file;
+    std::string stdin_text;
+    std::string_view input;
+    if ( !opts.inputs.empty() && opts.inputs[0] != "-" ) {
+        file.emplace( opts.inputs[0] );
+        input = file->view();
+    }
+    else {
+        stdin_text = read_all_stdin();
+        input = stdin_text;
+    }
+
+    std::FILE* out = stdout;
+    if ( opts.output && !(out = std::fopen( opts.output->c_str(), "wb" )) )
+        throw std::system_error( errno, std::generic_category(), "can't create " + *opts.output );
+    const std::string out_name = opts.output ? *opts.output : "stdout";
+
+    pipeline_stats stats;
+    try {
+        stats = multiply_pipeline( input, [&]( std::string_view product ) {
+                                       if ( std::fwrite( product.data(), 1, product.size(), out ) != product.size() )
+                                           throw std::runtime_error( "can't write to " + out_name );
+                                   },
+                                   opts.threads, opts.queue );
+    }
+    catch (...) {
+        if ( out != stdout )
+            std::fclose( out );
+        throw;
+    }
+
+    if ( (out != stdout ? std::fclose( out ) : std::fflush( out )) != 0 )
+        throw std::runtime_error( "can't write to " + out_name );
+
+    if ( opts.stats )
+        report_pipeline( stats );
+}
+
+
+
+
+// *******************************************************************************
+// server mode
+// *******************************************************************************
+//
+// SIGINT and SIGTERM are blocked before any threads start (so every thread
+// inherits that) and picked up by one thread waiting for them, which makes
+// shutting down plain code rather than a signal handler: it just stops the
+// server, which answers what it has already read and returns.
+//
+// *******************************************************************************
+//
+void run_server( const options& opts )
+{
+    sigset_t signals;
+    sigemptyset( &signals );
+    sigaddset( &signals, SIGINT );
+    sigaddset( &signals, SIGTERM );
+    pthread_sigmask( SIG_BLOCK, &signals, nullptr );
+
+    // (every multiply runs on the pool's workers; nothing else joins in)
+    WorkStealingPool pool( opts.threads );
+    MultiplyServer server( *opts.serve, pool, opts.queue );
+
+    std::atomic<bool> finished { false };
+    std::thread waiter( [&] {
+        const timespec poll_interval { 0, 200'000'000 };
+        while ( !finished )
+            if ( sigtimedwait( &signals, nullptr, &poll_interval ) > 0 ) {
+                server.stop();
+                return;
+            }
+    } );
+
+    std::fprintf( stderr, "bigmul: serving on %s with %u threads\n", opts.serve->c_str(), opts.threads );
+    try {
+        server.run();
+    }
+    catch (...) {
+        finished = true;
+        waiter.join();
+        throw;
+    }
+    finished = true;
+    waiter.join();
+
+    if ( opts.stats ) {
+        auto& s = server.statistics();
+        std::fprintf( stderr, "%-12s %lu\n%-12s %lu\n%-12s %lu (%.1f requests each)\n%-12s %lu\n",
+                      "connections", s.connections.load(), "requests", s.requests.load(),
+                      "batches", s.batches.load(), s.batches ? double( s.requests ) / s.batches : 0.0,
+                      "errors", s.errors.load() );
+    }
+}
+
+}
+
+
+
+int main( int argc, char* argv[] )
+{
+    options opts;
+    try {
+        opts = parse_command_line( argc, argv );
+    }
+    catch ( const usage_error& e ) {
+        std::cerr << "bigmul: " << e.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    try {
+        if ( opts.serve ) {
+            run_server( opts );
+            return 0;
+        }
+
+        if ( opts.batch ) {
+            run_batch( opts );
+            return 0;
+        }
+
+        phase_timer timer( opts.stats );
+
+        if ( opts.algo == algorithm::out_of_core ) {
+            karatsuba_out_of_core( opts.inputs[0], opts.inputs[1], *opts.output, opts.memory );
+
+            // (the product file is bare digits; end it with a newline like the
+            // other modes' output)
+            std::FILE* out = std::fopen( opts.output->c_str(), "ab" );
+            if ( !out )
+                throw std::system_error( errno, std::generic_category(), "can't open " + *opts.output );
+            bool written = std::fputc( '\n', out ) != EOF;
+            if ( std::fclose( out ) != 0 || !written )
+                throw std::runtime_error( "can't write to " + *opts.output );
+            timer.lap( "multiply", "(out-of-core, " + std::to_string( out_of_core_block_digits( opts.memory ) ) +
+                                   "-digit blocks)" );
+            return 0;
+        }
+
+        //
+        // this thread runs queued tasks while it waits on the pool, so it's one
+        // of the --threads (and with just the one, it multiplies on its own)
+        //
+        WorkStealingPool pool( std::max( 1u, opts.threads - 1 ) );
+        const bool sequential = opts.algo == algorithm::karatsuba || opts.threads == 1;
+
+        auto [x, y] = read_operands( opts, pool );
+        timer.lap( "parse", std::to_string( x.size() ) + " x " + std::to_string( y.size() ) + " digits" );
+
+        auto product = sequential ? karatsuba( x, y ) : karatsuba_parallel( x, y, pool, opts.cutoff );
+        timer.lap( "multiply", std::to_string( product.size() ) + " digits, " +
+                               (sequential ? std::string( "sequential" ) : std::to_string( opts.threads ) + " threads") );
+
+        write_product( product, opts, pool );
+        timer.lap( "format", opts.output ? *opts.output : std::string( "stdout" ) );
+    }
+    catch ( const std::exception& e ) {
+        std::cerr << "bigmul: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+//
+// bigmul_load.cpp
+//
+// created by PKXH on 19 Oct 2026
+//
+// Load generator for a multiplication server ('bigmul --serve'): a number of
+// connections each send a stream of random multiply requests, one at a time,
+// and the round-trip latencies are reported as percentiles.
+//
+// NOTE: build with:
+// g++-11 -std=c++2a -O2 -pthread -o bigmul_load IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp IntListIO.cpp karatsuba.cpp MultiplyServer.cpp bigmul_load.cpp
+//
+// and run 'bigmul_load --help' for the options.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "IntList.h"
+#include "MultiplyServer.h"
+#include "karatsuba.h"
+
+static const char* usage =
+    "usage: bigmul_load [options] SOCKET\n"
+    "\n"
+    "Send random multiply requests to the server listening on SOCKET and report\n"
+    "the round-trip latencies.\n"
+    "\n"
+    "options:\n"
+    "  -c, --connections N    concurrent connections (default 4)\n"
+    "  -n, --requests N       requests per connection (default 1000)\n"
+    "  -d, --digits N[,N...]  operand sizes to pick from at random (default 100)\n"
+    "      --check            check every product against a local multiply\n"
+    "  -h, --help             show this message\n";
+
+namespace {
+
+struct options
+{
+    std::string socket;
+    unsigned long connections = 4;
+    unsigned long requests = 1000;
+    std::vector<unsigned long> digits { 100 };
+    bool check = false;
+};
+
+options parse_command_line( int argc, char* argv[] )
+{
+    options opts;
+    bool have_socket = false;
+
+    for ( int i = 1; i < argc; ++i ) {
+        std::string_view arg = argv[i];
+
+        auto value = [&]() -> std::string_view {
+            if ( i+1 >= argc )
+                throw usage_error( std::string(arg) + " needs a value" );
+            return argv[++i];
+        };
+
+        if ( arg == "-h" || arg == "--help" ) {
+            std::cout << usage;
+            std::exit( 0 );
+        }
+        else if ( arg == "-c" || arg == "--connections" )
+            opts.connections = parse_count( arg, value() );
+        else if ( arg == "-n" || arg == "--requests" )
+            opts.requests = parse_count( arg, value() );
+        else if ( arg == "-d" || arg == "--digits" ) {
+            opts.digits.clear();
+            auto list = value();
+            for ( std::size_t start = 0; start <= list.size(); ) {
+                auto end = std::min( list.find( ',', start ), list.size() );
+                opts.digits.push_back( parse_count( arg, list.substr( start, end - start ) ) );
+                start = end + 1;
+            }
+        }
+        else if ( arg == "--check" )
+            opts.check = true;
+        else if ( arg.size() > 1 && arg[0] == '-' )
+            throw usage_error( "unknown option '" + std::string(arg) + "'" );
+        else if ( !have_socket ) {
+            opts.socket = arg;
+            have_socket = true;
+        }
+        else
+            throw usage_error( "expected one socket" );
+    }
+
+    if ( !have_socket )
+        throw usage_error( "which socket?" );
+    return opts;
+}
+
+// random value of exactly 'digits' digits
+IntList random_int_list( unsigned long digits, std::mt19937& rng )
+{
+    std::vector<IntList::value_type> v( digits );
+    for ( auto& d : v )
+        d = rng() % 10;
+    v[0] = 1 + rng() % 9;
+    return IntList( std::move(v) );
+}
+
+// what one connection saw
+struct connection_result
+{
+    std::vector<double> latencies;     // seconds
+    unsigned long wrong = 0;
+    std::string error;
+};
+
+void run_connection( const options& opts, unsigned int seed, connection_result& result )
+{
+    using clock = std::chrono::steady_clock;
+
+    try {
+        //
+        // operands are made up front, so the loop times nothing but round trips
+        //
+        std::mt19937 rng( seed );
+        const std::size_t distinct = std::min<unsigned long>( opts.requests, 16 );
+        std::vector<std::pair<IntList, IntList>> operands;
+        for ( std::size_t i = 0; i < distinct; ++i ) {
+            auto digits = opts.digits[ rng() % opts.digits.size() ];
+            operands.emplace_back( random_int_list( digits, rng ), random_int_list( digits, rng ) );
+        }
+
+        MultiplyClient client( opts.socket );
+        result.latencies.reserve( opts.requests );
+
+        for ( unsigned long r = 0; r < opts.requests; ++r ) {
+            auto& [x, y] = operands[ r % distinct ];
+
+            auto start = clock::now();
+            auto product = client.multiply( x, y );
+            result.latencies.push_back( std::chrono::duration<double>( clock::now() - start ).count() );
+
+            if ( opts.check && product != karatsuba( x, y ) )
+                ++result.wrong;
+        }
+    }
+    catch ( const std::exception& e ) {
+        result.error = e.what();
+    }
+}
+
+}
+
+
+
+int main( int argc, char* argv[] )
+{
+    options opts;
+    try {
+        opts = parse_command_line( argc, argv );
+    }
+    catch ( const usage_error& e ) {
+        std::cerr << "bigmul_load: " << e.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    std::vector<connection_result> results( opts.connections );
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned long c = 0; c < opts.connections; ++c )
+        threads.emplace_back( run_connection, std::cref( opts ), 1000 + c, std::ref( results[c] ) );
+    for ( auto& t : threads )
+        t.join();
+    double wall = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    std::vector<double> latencies;
+    unsigned long wrong = 0;
+    int status = 0;
+    for ( auto& r : results ) {
+        latencies.insert( latencies.end(), r.latencies.begin(), r.latencies.end() );
+        wrong += r.wrong;
+        if ( !r.error.empty() ) {
+            std::cerr << "bigmul_load: " << r.error << "\n";
+            status = 1;
+        }
+    }
+    if ( latencies.empty() )
+        return 1;
+    std::sort( latencies.begin(), latencies.end() );
+
+    auto percentile = [&]( double p ) {
+        auto i = std::min( latencies.size() - 1, std::size_t( p / 100 * latencies.size() ) );
+        return latencies[i] * 1000;
+    };
+
+    std::printf( "requests   %lu over %lu connections in %.3f s (%.1f/s)\n",
+                 (unsigned long) latencies.size(), opts.connections, wall, latencies.size() / wall );
+    std::printf( "latency    p50 %.3f ms   p90 %.3f ms   p99 %.3f ms   p99.9 %.3f ms   max %.3f ms\n",
+                 percentile( 50 ), percentile( 90 ), percentile( 99 ), percentile( 99.9 ), latencies.back() * 1000 );
+    if ( opts.check )
+        std::printf( "checked    %lu wrong\n", wrong );
+
+    return wrong ? 1 : status;
+}
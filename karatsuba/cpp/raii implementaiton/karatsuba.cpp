@@ -6,13 +6,30 @@
 // Implementation of Karatsuba multiplication
 //
 // NOTE: when updating code, compile with:
-// g++-11 -std=c++2a -DBUILD_KARATSUBA_UNIT_TEST_RUNNER IntList.cpp karatsuba.cpp
+// g++-11 -std=c++2a -pthread -DBUILD_KARATSUBA_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp karatsuba.cpp
 // and run a.out to test changes for breaks
 //
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
 #include <vector>
 
 #include "IntList.h"
+#include "SparseIntList.h"
+#include "IntListAccumulator.h"
+#include "FixedIntList.h"
+#include "WorkStealingPool.h"
+#include "IntListParallel.h"
+#include "karatsuba.h"
 
 // use this define to run unit tests without externally-defined test runner
 #if defined(BUILD_KARATSUBA_UNIT_TEST_RUNNER)
@@ -27,21 +44,11 @@
 #endif
 
 #ifdef BUILD_UNIT_TESTS
-#include <climits>
+#include "IntListTestUtils.h"
 #endif
 
 //using vui = std::vector<unsigned int>;
 
-#ifdef BUILD_UNIT_TESTS
-static unsigned int power(unsigned int base, unsigned int exponent) 
-{
-    unsigned int product = 1;
-    for (auto n=0; n<exponent; n++)
-        product *= base;
-    return product;
-}
-#endif
-
 // *******************************************************************************
 // split the specified integer list into two, with the 1st value's msd starting 
 // with il->size()-1, and the 2nd value's msd starting with spl_idx-1. 
@@ -208,13 +215,70 @@ BOOST_AUTO_TEST_CASE( zero_padded_integer_list_split_test )
 #endif // BUILD_UNIT_TESTS
 
 
+// operands up to this many digits are multiplied out directly by a
+// FixedIntList kernel rather than split any further
+static const std::size_t fixed_kernel_digits = 32;
+
+// where the recursion actually hands over to the kernel; the tests turn it
+// down (see kernel_cutoff_override) so small operands, whose products can be
+// checked against plain unsigned math, go through the recursion too
+#ifdef BUILD_UNIT_TESTS
+static std::size_t kernel_cutoff_digits = fixed_kernel_digits;
+#else
+static const std::size_t kernel_cutoff_digits = fixed_kernel_digits;
+#endif
+
+
+// largest combine (in digits) that uses the per-thread scratch accumulator
+static const unsigned long max_scratch_digits = 1UL << 16;
+
+
+// *******************************************************************************
+// Recombine the three Karatsuba sub-products of a split at m digits into the
+// full product: s1*10^(2m) + (s1xs2 - s1 - s2)*10^m + s2
+// *******************************************************************************
+//
+static IntList karatsuba_combine(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m,
+                                 IntListAccumulator& acc) {
+
+#ifdef BUILD_UNIT_TESTS
+    BOOST_ASSERT( s1xs2      >= s1 );   // (asserts rather than BOOST_CHECKs; this
+    BOOST_ASSERT( s1xs2 - s1 >= s2 );   // also runs on the parallel workers)
+#endif 
+
+    IntList s3 = lazy(s1xs2) - s1 - s2;    // (one fused pass)
+
+    //
+    // s1*10^(2m) + s3*10^m + s2, with the carries resolved in a single pass.
+    //
+    acc.reserve( s1.size() + m*2 + 1 );
+    acc.add_shifted( s1, m*2 );
+    acc.add_shifted( s3, m   );
+    acc.add        ( s2      );
+    return acc.finish();
+}
+//
+// Each thread keeps one accumulator around as scratch, so the thousands of
+// small combines in a recursion (or a batch) reuse its lanes instead of
+// allocating their own; only really big combines get a one-off.
+//
+static IntList karatsuba_combine(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m) {
+
+    static thread_local IntListAccumulator scratch( max_scratch_digits );
+
+    auto digits = s1.size() + m*2 + 1;
+    IntListAccumulator one_off;
+    return karatsuba_combine( s1, s2, s1xs2, m, digits <= max_scratch_digits ? scratch : one_off );
+}
+
+
 // *******************************************************************************
 // Calculate a product using Karatsuba multiplication.
 // x, y are integer list representations of arbitrarily large integers
 // returns an IntList containing the product of the inputs 
 // *******************************************************************************
 //
-IntList karatsuba(const IntList& x, const IntList& y) {
+static IntList karatsuba_dense(const IntList& x, const IntList& y) {
 
     auto x_size = x.size();
     auto y_size = y.size();
@@ -235,62 +299,268 @@ IntList karatsuba(const IntList& x, const IntList& y) {
         return one_digit_product;
     }
 
+    // small enough for the stack-allocated, unrolled schoolbook kernel
+    else if (x_size <= kernel_cutoff_digits && y_size <= kernel_cutoff_digits) {
+
+        auto product = FixedIntList<fixed_kernel_digits>(x) * FixedIntList<fixed_kernel_digits>(y);
+        return product.to_int_list();
+    }
+
     else {
 
         auto max_size = std::max(x_size, y_size);
-        auto m  = max_size/2 + (max_size%2?1:0); // take the ceil
-        auto m2 = m*2;
+        auto m  = karatsuba_split_point(max_size);
 
         auto [a,b] = split_zero_padded_int_list( x, max_size-m, max_size );  // on odd-lengthed values, split so the most 
         auto [c,d] = split_zero_padded_int_list( y, max_size-m, max_size );  // significant part is smaller
 
-        auto    s1 = karatsuba(a,c);
-        auto    s2 = karatsuba(b,d);
-        auto s1xs2 = karatsuba(a+b,c+d);
-
-#ifdef BUILD_UNIT_TESTS
-        BOOST_CHECK( s1xs2      >= s1 );
-        BOOST_CHECK( s1xs2 - s1 >= s2 );
-#endif 
-
-        auto s3 = s1xs2 - s1 - s2;
+        auto    s1 = karatsuba_dense(a,c);
+        auto    s2 = karatsuba_dense(b,d);
+        auto s1xs2 = karatsuba_dense(a+b,c+d);
 
-        auto s1zs = s1.clone();
-        for (auto i=0; i < m2; i++)
-            s1zs.push_back(0);
-
-        auto s3zs = s3.clone();
-        for (auto i=0; i < m; i++)
-            s3zs.push_back(0);
+        auto product = karatsuba_combine( s1, s2, s1xs2, m );
 
 #ifdef BUILD_UNIT_TESTS
         {   //
-            // if it shouldn't be greater than unsigned maxint, check our 0-appends against
-            // the actual multiplied-out version of the numbers
+            // if it shouldn't be greater than unsigned maxint, check our shifted sum
+            // against the actual multiplied-out version of the numbers (only
+            // reachable with the kernel cutoff turned down below 9 digits)
             //
             static IntList max_int (UINT_MAX);
 
-            if ( s1zs.size() < max_int.size() ) {
-                // 
-                // a.k.a. s1 == lhs * 10^(m2) ? 
-                //
-                IntList lhs_expo_version ( s1.to_uint() * power(10,m2) );
-                BOOST_CHECK( s1zs == lhs_expo_version );
-            }
-
-            if ( s3zs.size() < max_int.size() ) {
-                //
-                // a.k.a. s3 == rhs * 10^m ?
-                //
-                IntList rhs_expo_version ( s3.to_uint() * power(10,m) );
-                BOOST_CHECK( s3zs == rhs_expo_version );
+            if ( x_size + y_size < max_int.size() ) {
+                IntList expected ( x.to_uint() * y.to_uint() );
+                BOOST_ASSERT( product == expected );
             }
         }
 #endif
 
-        return s1zs + s2 + s3zs;  
+        return product;
     }
 }
+//
+// a fork slot out of 'slots', if there's one left (and always, with no limit)
+//
+static bool take_fork_slot(std::atomic<unsigned int>* slots) {
+
+    if (!slots)
+        return true;
+
+    for (auto n = slots->load(); n > 0; )
+        if (slots->compare_exchange_weak(n, n-1))
+            return true;
+    return false;
+}
+//
+static void give_back_fork_slot(std::atomic<unsigned int>* slots) {
+
+    if (slots)
+        ++*slots;
+}
+//
+// same thing, but forking the s1 and s2 sub-products off as pool tasks (as
+// long as the operands are still longer than 'cutoff_digits'); below that it
+// carries on sequentially. With 'slots', a sub-product is only forked if it
+// can take one (and gives it back when it's done), so no more than that many
+// forks are in flight at once; one that can't is left for this thread. While
+// waiting on its forks, the calling thread helps run whatever is queued.
+//
+static IntList karatsuba_dense_parallel(const IntList& x, const IntList& y, WorkStealingPool& pool,
+                                        unsigned long cutoff_digits, std::atomic<unsigned int>* slots = nullptr) {
+
+    auto max_size = std::max(x.size(), y.size());
+
+    if (max_size <= cutoff_digits || max_size <= kernel_cutoff_digits)
+        return karatsuba_dense(x, y);
+
+    auto m = karatsuba_split_point(max_size);
+
+    auto ab = split_zero_padded_int_list( x, max_size-m, max_size );
+    auto cd = split_zero_padded_int_list( y, max_size-m, max_size );
+    const IntList& a = ab.first;
+    const IntList& b = ab.second;
+    const IntList& c = cd.first;
+    const IntList& d = cd.second;
+
+    auto sub_product = [&](const IntList& p, const IntList& q) {
+        return karatsuba_dense_parallel(p, q, pool, cutoff_digits, slots);
+    };
+    auto fork = [&](std::optional<WorkStealingPool::task_handle<IntList>>& task, const IntList& p, const IntList& q) {
+        if (!take_fork_slot(slots))
+            return;
+        try {
+            task = pool.fork( [&sub_product, slots, &p = p, &q = q]{
+                try {
+                    auto product = sub_product(p, q);
+                    give_back_fork_slot(slots);
+                    return product;
+                }
+                catch (...) {
+                    give_back_fork_slot(slots);
+                    throw;
+                }
+            } );
+        }
+        catch (...) {
+            give_back_fork_slot(slots);
+            throw;
+        }
+    };
+
+    std::optional<WorkStealingPool::task_handle<IntList>> s1_task, s2_task;
+    IntList s1xs2( 0 ), s1( 0 ), s2( 0 );
+    try {
+        fork( s1_task, a, c );
+        fork( s2_task, b, d );
+
+        // (the operand sums are big enough up here to be split across the pool
+        // too, unless it's only got a few slots to work with)
+        s1xs2 = slots ? sub_product( IntList(a + b), IntList(c + d) )
+                      : sub_product( add_parallel(a, b, pool), add_parallel(c, d, pool) );
+        s1    = s1_task ? pool.join( *s1_task ) : sub_product( a, c );
+        s2    = s2_task ? pool.join( *s2_task ) : sub_product( b, d );
+    }
+    catch (...) {
+        // the forks (the ones that got made) still refer to a..d; let them
+        // finish before those go
+        if ( s1_task ) pool.wait( *s1_task );
+        if ( s2_task ) pool.wait( *s2_task );
+        throw;
+    }
+
+    return karatsuba_combine( s1, s2, s1xs2, m );
+}
+//
+// (the block-by-block product, and what it's estimated to cost; with the
+// sparse karatsuba further down)
+//
+static double karatsuba_blocks_cost(const SparseIntList& x, const SparseIntList& y);
+static IntList karatsuba_blocks(const SparseIntList& x, const SparseIntList& y);
+//
+// values that are mostly long runs of zeros (10^k + c and the like) can be
+// much cheaper to multiply block-by-block, but a sparse value with many
+// blocks times a dense one can be far dearer: only go sparse when the block
+// products come out cheaper than the dense recursion over the full lengths.
+//
+static std::optional<IntList> karatsuba_if_sparse(const IntList& x, const IntList& y) {
+
+    if ( !SparseIntList::should_be_sparse(x) && !SparseIntList::should_be_sparse(y) )
+        return std::nullopt;
+
+    SparseIntList xs(x), ys(y);
+    if ( karatsuba_blocks_cost(xs, ys) >= karatsuba_cost(x.size(), y.size()) )
+        return std::nullopt;
+
+    return karatsuba_blocks(xs, ys);
+}
+//
+bool karatsuba_goes_sparse(const IntList& x, const IntList& y) {
+
+    if ( !SparseIntList::should_be_sparse(x) && !SparseIntList::should_be_sparse(y) )
+        return false;
+
+    return karatsuba_blocks_cost( SparseIntList(x), SparseIntList(y) ) < karatsuba_cost(x.size(), y.size());
+}
+//
+IntList karatsuba(const IntList& x, const IntList& y) {
+
+    if ( auto product = karatsuba_if_sparse(x, y) )
+        return std::move(*product);
+
+    return karatsuba_dense(x, y);
+}
+//
+IntList karatsuba_parallel(const IntList& x, const IntList& y, unsigned int threads, unsigned long cutoff_digits) {
+
+    if ( auto product = karatsuba_if_sparse(x, y) )
+        return std::move(*product);
+
+    if ( threads <= 1 || std::max(x.size(), y.size()) <= cutoff_digits )
+        return karatsuba_dense(x, y);
+
+    //
+    // on the shared pool (so concurrent callers share its workers rather than
+    // each starting their own), but with no more than threads-1 forks in
+    // flight: the calling thread runs queued tasks while it waits on its
+    // forks, so it's one of the 'threads'
+    //
+    std::atomic<unsigned int> slots { threads - 1 };
+    return karatsuba_dense_parallel(x, y, WorkStealingPool::shared(), cutoff_digits, &slots);
+}
+//
+IntList karatsuba_parallel(const IntList& x, const IntList& y, WorkStealingPool& pool, unsigned long cutoff_digits) {
+
+    if ( auto product = karatsuba_if_sparse(x, y) )
+        return std::move(*product);
+
+    // fork all the way down to the cutoff and let the workers balance it out
+    return karatsuba_dense_parallel(x, y, pool, cutoff_digits);
+}
+
+//
+double karatsuba_cost(unsigned long x_digits, unsigned long y_digits) {
+
+    return std::pow( double( std::max(x_digits, y_digits) ), std::log2(3.0) );
+}
+//
+karatsuba_step karatsuba_split(const IntList& x, const IntList& y) {
+
+    auto max_size = std::max(x.size(), y.size());
+    if (max_size < 2)
+        throw std::invalid_argument( "can't split single-digit operands" );
+
+    auto [a,b,a_b] = split_into_halves( x, max_size );
+    auto [c,d,c_d] = split_into_halves( y, max_size );
+    return { karatsuba_split_point(max_size),
+             { std::move(a), std::move(c) }, { std::move(b), std::move(d) }, { std::move(a_b), std::move(c_d) } };
+}
+//
+IntList karatsuba_join(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m) {
+
+    return karatsuba_combine( s1, s2, s1xs2, m );
+}
+//
+IntList karatsuba_join(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m,
+                       IntListAccumulator& scratch) {
+
+    return karatsuba_combine( s1, s2, s1xs2, m, scratch );
+}
+//
+unsigned long karatsuba_split_point(unsigned long digits) {
+
+    return digits/2 + digits%2;     // (the ceil)
+}
+//
+karatsuba_halves split_into_halves(const IntList& x, unsigned long digits) {
+
+    karatsuba_halves halves { IntList(0), IntList(0), IntList(0) };
+    split_into_halves( x, digits, halves );
+    return halves;
+}
+//
+void split_into_halves(const IntList& x, unsigned long digits, karatsuba_halves& into) {
+
+    // (as split_zero_padded_int_list does it: the padding comes off the high half)
+    auto hi_digits = digits - karatsuba_split_point(digits);
+    auto pad = digits - x.size();
+    auto cut = pad < hi_digits ? hi_digits - pad : 0;
+
+    into.hi.assign_digits( x, 0, cut );
+    into.lo.assign_digits( x, cut, x.size() );
+    (lazy(into.hi) + into.lo).evaluate_into( into.sum );
+}
+//
+std::vector<std::pair<IntList, unsigned long>> lsd_pieces(const IntList& x, unsigned long piece_digits) {
+
+    std::vector<std::pair<IntList, unsigned long>> pieces;
+    for ( unsigned long end = x.size(); end > 0; ) {
+        unsigned long begin = end > piece_digits ? end - piece_digits : 0;
+        pieces.emplace_back( IntList( std::vector<IntList::value_type>( x.cbegin() + begin, x.cbegin() + end ) ),
+                             x.size() - end );
+        end = begin;
+    }
+    return pieces;
+}
 
 #ifdef BUILD_UNIT_TESTS
 
@@ -361,4 +631,544 @@ BOOST_AUTO_TEST_CASE( test_karatusba_multiplication )
     }
 }
 
+BOOST_AUTO_TEST_CASE( test_karatsuba_step )
+{   //
+    // a split and a join around three separate sub-products is the same product
+    //
+    const unsigned int pairs[][2] = { { 56789, 12345 }, { 18, 456 }, { 73134, 81168 }, { 10, 7 } };
+    for ( auto [xi, yi] : pairs ) {
+        IntList x( xi ), y( yi );
+        auto step = karatsuba_split( x, y );
+        auto s1    = karatsuba( step.s1.first,    step.s1.second    );
+        auto s2    = karatsuba( step.s2.first,    step.s2.second    );
+        auto s1xs2 = karatsuba( step.s1xs2.first, step.s1xs2.second );
+        BOOST_CHECK( karatsuba_join( s1, s2, s1xs2, step.m ) == karatsuba( x, y ) );
+    }
+
+    BOOST_CHECK( karatsuba_split( IntList(12345), IntList(1) ).m == 3 );
+    BOOST_CHECK_THROW( karatsuba_split( IntList(7), IntList(8) ), std::invalid_argument );
+
+    {   //
+        // the nominal-length helpers: 12345 padded to 6 digits splits 012|345,
+        // and 7 pieces of 1234567 go 567, 234, 1 (lsd end first)
+        //
+        BOOST_CHECK( karatsuba_split_point( 6 ) == 3 && karatsuba_split_point( 7 ) == 4 );
+
+        auto [hi, lo, sum] = split_into_halves( IntList(12345), 6 );
+        BOOST_CHECK( hi == IntList(12) && lo == IntList(345) && sum == IntList(357) );
+
+        // (and into ones kept from a split before)
+        karatsuba_halves kept { IntList(999999), IntList(9), IntList(0) };
+        split_into_halves( IntList(1000005), 8, kept );
+        BOOST_CHECK( kept.hi == IntList(100) && kept.lo == IntList(5) && kept.sum == IntList(105) );
+
+        auto pieces = lsd_pieces( IntList(1234567), 3 );
+        BOOST_CHECK( pieces.size() == 3 );
+        BOOST_CHECK( pieces[0].first == IntList(567) && pieces[0].second == 0 );
+        BOOST_CHECK( pieces[1].first == IntList(234) && pieces[1].second == 3 );
+        BOOST_CHECK( pieces[2].first == IntList(1)   && pieces[2].second == 6 );
+    }
+
+    BOOST_CHECK( karatsuba_cost( 1000, 10 ) == karatsuba_cost( 10, 1000 ) );
+    BOOST_CHECK( karatsuba_cost( 2000, 2000 ) / karatsuba_cost( 1000, 1000 ) > 2.99 );
+}
+
+#endif // BUILD_UNIT_TESTS
+
+
+#ifdef BUILD_UNIT_TESTS
+
+// turns the kernel cutoff down for as long as it's in scope
+struct kernel_cutoff_override
+{
+    std::size_t saved;
+    explicit kernel_cutoff_override( std::size_t digits ) : saved( kernel_cutoff_digits ) { kernel_cutoff_digits = digits; }
+    ~kernel_cutoff_override() { kernel_cutoff_digits = saved; }
+};
+
+BOOST_AUTO_TEST_CASE( test_karatsuba_recursion_below_kernel )
+{   //
+    // with the kernel out of the way, small operands recurse all the way down
+    // to single digits (and through the unsigned-math cross-check on the way)
+    //
+    std::srand(time(nullptr));
+
+    for ( std::size_t cutoff : { std::size_t(0), std::size_t(1), std::size_t(3) } ) {
+        kernel_cutoff_override below( cutoff );
+
+        for ( int i=0; i < 2000; i++ ) {
+            unsigned long a = std::rand() % 99999;
+            unsigned long b = std::rand() % 9999;
+            BOOST_CHECK( karatsuba( IntList(a), IntList(b) ) == IntList(a*b) );
+        }
+    }
+
+    {   //
+        // and bigger ones, recursing below the cutoff, agree with the kernel
+        //
+        std::vector<IntList> xs, ys, products;
+        for ( int i=0; i < 50; i++ ) {
+            xs.push_back( random_int_list( 1 + std::rand() % 200 ) );
+            ys.push_back( random_int_list( 1 + std::rand() % 200 ) );
+            products.push_back( karatsuba( xs.back(), ys.back() ) );
+        }
+
+        kernel_cutoff_override below( 2 );
+        for ( int i=0; i < 50; i++ )
+            BOOST_CHECK( karatsuba( xs[i], ys[i] ) == products[i] );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_parallel_karatsuba_multiplication )
+{   //
+    // the parallel variant has to agree with the sequential one no matter how
+    // many threads or how small a cutoff it's given
+    //
+    std::srand(time(nullptr));
+
+    for ( unsigned int threads : { 1u, 2u, 3u, 8u, 32u } ) {
+        for ( int i=0; i < 5; i++ ) {
+            auto x = random_int_list( 1 + std::rand() % 3000 );
+            auto y = random_int_list( 1 + std::rand() % 3000 );
+
+            BOOST_CHECK( karatsuba_parallel( x, y, threads, 64 ) == karatsuba( x, y ) );
+        }
+    }
+
+    {   //
+        // several callers at once, each held to its own thread count on the
+        // shared pool
+        //
+        std::vector<IntList> xs, ys, products;
+        for ( int i=0; i < 4; i++ ) {
+            xs.push_back( random_int_list( 500 + std::rand() % 3000 ) );
+            ys.push_back( random_int_list( 500 + std::rand() % 3000 ) );
+            products.push_back( IntList(0) );
+        }
+
+        std::vector<std::thread> callers;
+        for ( int i=0; i < 4; i++ )
+            callers.emplace_back( [&, i]{ products[i] = karatsuba_parallel( xs[i], ys[i], 1u + i, 64 ); } );
+        for ( auto& c : callers )
+            c.join();
+
+        for ( int i=0; i < 4; i++ )
+            BOOST_CHECK( products[i] == karatsuba( xs[i], ys[i] ) );
+    }
+
+    {   //
+        // small operands never fork
+        //
+        IntList x( 1234 );
+        IntList y( 5678 );
+        BOOST_CHECK( karatsuba_parallel( x, y, 8 ) == IntList( 7006652 ) );
+    }
+
+    {   //
+        // a private pool, forked all the way down to a small cutoff, with a few
+        // multiplies running on it at once
+        //
+        WorkStealingPool pool(4);
+
+        std::vector<IntList> xs, ys, products;
+        for ( int i=0; i < 4; i++ ) {
+            xs.push_back( random_int_list( 500 + std::rand() % 2000 ) );
+            ys.push_back( random_int_list( 500 + std::rand() % 2000 ) );
+            products.push_back( IntList(0) );
+        }
+
+        std::vector<std::thread> callers;
+        for ( int i=0; i < 4; i++ )
+            callers.emplace_back( [&, i]{ products[i] = karatsuba_parallel( xs[i], ys[i], pool, 64 ); } );
+        for ( auto& c : callers )
+            c.join();
+
+        for ( int i=0; i < 4; i++ )
+            BOOST_CHECK( products[i] == karatsuba( xs[i], ys[i] ) );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+
+
+// *******************************************************************************
+// Calculate a whole batch of products.
+// Sorting the pairs by size class (the bit width of their combined digit count)
+// means each task works through operands of about the same size, so the
+// per-thread scratch in karatsuba_combine and the allocator's free lists stay
+// warm. The sorted pairs are then cut into runs of roughly equal estimated cost
+// (karatsuba_cost), with a few runs per worker so stealing can even
+// out the estimate's mistakes. Any pair big enough to be worth splitting on its
+// own goes through karatsuba_parallel on the same pool instead.
+// *******************************************************************************
+//
+void multiply_batch(std::span<const std::pair<const IntList*, const IntList*>> pairs, std::span<IntList> out,
+                    WorkStealingPool& pool) {
+
+    if ( out.size() < pairs.size() )
+        throw std::invalid_argument( "out (" + std::to_string(out.size()) + ") must be >= pairs (" +
+                                     std::to_string(pairs.size()) + ")" );
+
+    auto digits     = [&]( std::size_t i ) { return pairs[i].first->size() + pairs[i].second->size(); };
+    auto size_class = [&]( std::size_t i ) { return std::bit_width( digits(i) ); };
+    auto cost       = [&]( std::size_t i ) { return karatsuba_cost( pairs[i].first->size(), pairs[i].second->size() ); };
+
+    std::vector<std::size_t> order( pairs.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(),
+                      [&]( auto i, auto j ) { return size_class(i) < size_class(j); } );
+
+    double total_cost = 0;
+    for ( auto i : order )
+        total_cost += cost(i);
+    const double run_cost = total_cost / (pool.size() * 4);
+
+    auto multiply = [&]( std::size_t i ) {
+        const IntList& x = *pairs[i].first;
+        const IntList& y = *pairs[i].second;
+        out[i] = std::max( x.size(), y.size() ) > default_parallel_cutoff_digits * 2
+               ? karatsuba_parallel( x, y, pool )
+               : karatsuba( x, y );
+    };
+
+    //
+    // join everything before letting any exception out (including one from
+    // forking part way through); the runs still refer to our locals
+    //
+    std::vector<WorkStealingPool::task_handle<void>> runs;
+    std::exception_ptr error;
+    try {
+        for ( std::size_t begin = 0; begin < order.size(); ) {
+            std::size_t end = begin;
+            double cost_so_far = 0;
+            while ( end < order.size() && (end == begin || cost_so_far + cost(order[end]) <= run_cost) )
+                cost_so_far += cost( order[end++] );
+
+            runs.push_back( pool.fork( [&, begin, end]{
+                for ( auto n = begin; n < end; ++n )
+                    multiply( order[n] );
+            } ) );
+            begin = end;
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    for ( auto& r : runs )
+        try { pool.join( r ); }
+        catch (...) { if (!error) error = std::current_exception(); }
+
+    if ( error )
+        std::rethrow_exception( error );
+}
+
+#ifdef BUILD_UNIT_TESTS
+
+BOOST_AUTO_TEST_CASE( test_batch_multiplication )
+{   //
+    // every product in a batch of mixed sizes has to match the one-at-a-time
+    // version, and land in the slot of its own pair
+    //
+    std::srand(time(nullptr));
+
+    std::vector<IntList> xs, ys;
+    for ( int i=0; i < 200; i++ ) {
+        auto size_class = std::rand() % 4;
+        unsigned long max_digits = size_class == 0 ?   10 :
+                                   size_class == 1 ?  100 :
+                                   size_class == 2 ? 1000 : 5000;
+        xs.push_back( random_int_list( 1 + std::rand() % max_digits ) );
+        ys.push_back( random_int_list( 1 + std::rand() % max_digits ) );
+    }
+
+    std::vector<std::pair<const IntList*, const IntList*>> pairs;
+    std::vector<IntList> products;
+    for ( std::size_t i=0; i < xs.size(); i++ ) {
+        pairs.emplace_back( &xs[i], &ys[i] );
+        products.push_back( IntList(0) );
+    }
+
+    for ( unsigned int threads : { 1u, 4u } ) {
+        WorkStealingPool pool( threads );
+        multiply_batch( pairs, products, pool );
+
+        bool all_good = true;
+        for ( std::size_t i=0; i < xs.size(); i++ )
+            all_good &= products[i] == karatsuba( xs[i], ys[i] );
+        BOOST_CHECK( all_good );
+    }
+
+    {   //
+        // the same operand can show up in more than one pair
+        //
+        IntList x( 1234 );
+        std::vector<std::pair<const IntList*, const IntList*>> squares { {&x, &x}, {&x, &xs[0]} };
+        std::vector<IntList> out;
+        out.push_back( IntList(0) );
+        out.push_back( IntList(0) );
+
+        multiply_batch( squares, out );
+        BOOST_CHECK( out[0] == IntList( 1522756 ) );
+        BOOST_CHECK( out[1] == karatsuba( x, xs[0] ) );
+    }
+
+    {   //
+        // empty batches are fine; too little room for the results is not
+        //
+        std::vector<IntList> none;
+        BOOST_CHECK_NO_THROW( multiply_batch( {}, none ) );
+        BOOST_CHECK_THROW( multiply_batch( pairs, std::span<IntList>( products ).first(10) ), std::invalid_argument );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+
+
+// *******************************************************************************
+// Calculate a product of two sparse integer lists.
+// Every pair of non-zero blocks is multiplied out densely, and the partial
+// products are summed at the combined offset of their blocks; the zero runs
+// between blocks are never multiplied.
+//
+// Blocks of different lengths aren't padded out to each other: the longer one
+// is cut into pieces as long as the shorter, and each piece multiplied by it
+// (so a block pair costs pieces * the short length^log2(3), not the long
+// length^log2(3)). The partial products all go into one accumulator, which
+// resolves the carries once at the end.
+// *******************************************************************************
+//
+// dense recursion units each block product costs on top of its arithmetic
+// (the IntLists for its operands and product); measured, roughly
+static const double block_product_overhead = 2;
+//
+static double karatsuba_blocks_cost(const SparseIntList& x, const SparseIntList& y) {
+
+    double cost = 0;
+    for ( const auto& xb : x.get_blocks() )
+        for ( const auto& yb : y.get_blocks() ) {
+            auto short_len = std::min( xb.digits.size(), yb.digits.size() );
+            auto long_len  = std::max( xb.digits.size(), yb.digits.size() );
+            auto pieces = (long_len + short_len - 1) / short_len;
+            cost += pieces * ( karatsuba_cost(short_len, short_len) + 2*short_len + block_product_overhead );
+        }
+    return cost;
+}
+//
+static IntList karatsuba_blocks(const SparseIntList& x, const SparseIntList& y) {
+
+    auto as_int_list = []( const SparseIntList::block& b ) { return IntList( std::vector( b.digits ) ); };
+    std::vector<IntList> ys;
+    for ( const auto& yb : y.get_blocks() )
+        ys.push_back( as_int_list( yb ) );
+
+    IntListAccumulator product( x.size() + y.size() );
+
+    for ( const auto& xb : x.get_blocks() ) {
+        auto xi = as_int_list( xb );
+        for ( std::size_t j = 0; j < ys.size(); ++j ) {
+            const auto& yb = y.get_blocks()[j];
+            auto offset = xb.offset + yb.offset;
+
+            bool x_longer = xb.digits.size() > yb.digits.size();
+            const auto& long_digits = x_longer ? xb.digits : yb.digits;
+            const IntList& short_block = x_longer ? ys[j] : xi;
+            auto piece_len = std::min( xb.digits.size(), yb.digits.size() );
+
+            if ( long_digits.size() == piece_len ) {
+                product.add_shifted( karatsuba_dense( xi, ys[j] ), offset );
+                continue;
+            }
+
+            //
+            // the long block a piece at a time, lsd end first (its digits
+            // are msd-first, so the pieces are counted back from the end)
+            //
+            for ( std::size_t done = 0; done < long_digits.size(); done += piece_len ) {
+                auto end = long_digits.end() - done;
+                auto begin = end - std::min( piece_len, long_digits.size() - done );
+                IntList piece( std::vector<IntList::value_type>( begin, end ) );
+                product.add_shifted( karatsuba_dense( piece, short_block ), offset + done );
+            }
+        }
+    }
+
+    return product.finish();
+}
+//
+SparseIntList karatsuba(const SparseIntList& x, const SparseIntList& y) {
+
+    return SparseIntList( karatsuba_blocks(x, y) );
+}
+
+#ifdef BUILD_UNIT_TESTS
+
+BOOST_AUTO_TEST_CASE( test_sparse_karatsuba_multiplication )
+{   //
+    // (10^k + c) * (10^j + d) = 10^(k+j) + d*10^k + c*10^j + c*d
+    //
+    {
+        std::vector<unsigned int> xv( 101, 0 ); xv[0] = 1; xv[99] = 4; xv[100] = 2;  // 10^100 + 42
+        std::vector<unsigned int> yv(  81, 0 ); yv[0] = 1; yv[80] = 7;               // 10^80  + 7
+        IntList x( xv );
+        IntList y( yv );
+
+        std::vector<unsigned int> pv( 181, 0 );
+        pv[0] = 1;                                 // 10^180
+        pv[181-1-100] = 7;                         // 7*10^100
+        pv[181-1-81] = 4; pv[181-1-80] = 2;        // 42*10^80
+        pv[181-1-2] = 2; pv[181-1-1] = 9; pv[181-1-0] = 4;  // 42*7 = 294
+        IntList expected( pv );
+
+        BOOST_CHECK( SparseIntList::should_be_sparse(x) );
+        BOOST_CHECK( karatsuba( SparseIntList(x), SparseIntList(y) ).to_int_list() == expected );
+        BOOST_CHECK( karatsuba( x, y ) == expected );
+        BOOST_CHECK( karatsuba_dense( x, y ) == expected );
+    }
+
+    {   //
+        // random sparse values against the dense product
+        //
+        std::srand(time(nullptr));
+        for ( int i=0; i < 100; i++ ) {
+            std::vector<unsigned int> xv( 64 + std::rand() % 100, 0 );
+            std::vector<unsigned int> yv(  1 + std::rand() % 100, 0 );
+            xv[0] = 1 + std::rand() % 9;
+            for ( int j = std::rand() % 6; j > 0; --j ) xv[ std::rand() % xv.size() ] = std::rand() % 10;
+            for ( int j = std::rand() % 6; j > 0; --j ) yv[ std::rand() % yv.size() ] = std::rand() % 10;
+
+            IntList x( xv );
+            IntList y( yv );
+
+            BOOST_CHECK( karatsuba( x, y ) == karatsuba_dense( x, y ) );
+        }
+    }
+
+    {   //
+        // a dense value times one with a digit every 10th place is sparse by
+        // its density, but it has hundreds of blocks: block by block, that's
+        // hundreds of products as long as the dense value, so karatsuba stays
+        // dense. (Block by block still has to come out the same, long blocks
+        // cut into pieces against short ones.)
+        //
+        auto every = []( unsigned long digits, unsigned long k ) {
+            std::vector<unsigned int> v( digits, 0 );
+            for ( unsigned long i = 0; i < digits; i += k )
+                v[i] = 1 + std::rand() % 9;
+            return IntList( v );
+        };
+
+        auto x = random_int_list( 4000 );
+        auto y = every( 4000, 10 );
+        BOOST_CHECK( SparseIntList::should_be_sparse(y) && SparseIntList(y).get_blocks().size() == 400 );
+        BOOST_CHECK( !karatsuba_goes_sparse( x, y ) && !karatsuba_goes_sparse( y, x ) );
+        BOOST_CHECK( karatsuba( x, y ) == karatsuba_dense( x, y ) );
+
+        auto small_x = random_int_list( 700 );
+        auto small_y = every( 700, 10 );
+        BOOST_CHECK( karatsuba( SparseIntList(small_x), SparseIntList(small_y) ).to_int_list() ==
+                     karatsuba_dense( small_x, small_y ) );
+        BOOST_CHECK( karatsuba( SparseIntList(small_y), SparseIntList(small_x) ).to_int_list() ==
+                     karatsuba_dense( small_x, small_y ) );
+
+        // ...while two values that sparse do go block by block
+        auto z = every( 4000, 400 );
+        BOOST_CHECK( karatsuba_goes_sparse( z, every( 4000, 500 ) ) );
+        BOOST_CHECK( karatsuba_goes_sparse( z, x ) );
+        BOOST_CHECK( karatsuba( z, x ) == karatsuba_dense( z, x ) );
+    }
+}
+
+#endif // BUILD_UNIT_TESTS
+
+
+// *******************************************************************************
+// Convert a binary number (64-bit limbs, least significant first) to decimal.
+//
+// Divide and conquer: the low 2^k limbs and the rest are converted separately
+// (2^k being the biggest power of two short of the length) and put back
+// together as hi * 2^(64*2^k) + lo, so the work is a few multiplies of each
+// size rather than a digit-by-digit sweep per limb.
+//
+// The powers 2^(64*2^k) are kept in a table, each the square of the one
+// before, built as far as it's been needed so far (under a lock, so threads
+// share it) and kept for the rest of the program; a deque, so handing out
+// references to them is safe while it grows.
+// *******************************************************************************
+//
+static const IntList& binary_base_power(unsigned k) {
+
+    static std::mutex lock;
+    static std::deque<IntList> powers;
+
+    std::lock_guard<std::mutex> guard( lock );
+    if ( powers.empty() )
+        powers.emplace_back( (unsigned __int128)1 << 64 );
+    while ( powers.size() <= k )
+        powers.push_back( karatsuba( powers.back(), powers.back() ) );
+    return powers[k];
+}
+
+static IntList from_binary_limbs(const std::uint64_t* limbs, std::size_t n) {
+
+    if ( n <= 2 )
+        return IntList( ((unsigned __int128)( n == 2 ? limbs[1] : 0 ) << 64) | limbs[0] );
+
+    unsigned k = std::bit_width( n-1 ) - 1;
+    std::size_t half = std::size_t(1) << k;
+
+    auto lo = from_binary_limbs( limbs, half );
+    auto hi = from_binary_limbs( limbs + half, n - half );
+    IntList result = karatsuba( hi, binary_base_power( k ) ) + lo;
+    return result;
+}
+
+IntList from_binary(std::span<const std::uint64_t> limbs) {
+
+    auto n = limbs.size();
+    while ( n > 0 && limbs[n-1] == 0 )
+        --n;
+    if ( n == 0 )
+        return IntList( 0 );
+    return from_binary_limbs( limbs.data(), n );
+}
+
+#ifdef BUILD_UNIT_TESTS
+
+BOOST_AUTO_TEST_CASE( test_from_binary )
+{
+    {   //
+        // a few we know
+        //
+        BOOST_CHECK( from_binary( {} ) == IntList( 0 ) );
+        std::vector<std::uint64_t> zeros( 5, 0 );
+        BOOST_CHECK( from_binary( zeros ) == IntList( 0 ) );
+
+        std::vector<std::uint64_t> two_128 { 0, 0, 1 };
+        BOOST_CHECK( from_binary( two_128 ).to_str() == "340282366920938463463374607431768211456" );
+
+        std::vector<std::uint64_t> max_64 { UINT64_MAX, 0, 0 };   // (high zero limbs are ignored)
+        BOOST_CHECK( from_binary( max_64 ).to_u64() == UINT64_MAX );
+    }
+
+    {   //
+        // random lengths against Horner's rule, a limb at a time
+        //
+        std::srand(time(nullptr));
+        IntList base( (unsigned __int128)1 << 64 );
+        for ( int i=0; i < 40; i++ ) {
+            std::vector<std::uint64_t> limbs( 1 + std::rand() % (i < 30 ? 20 : 200) );
+            for ( auto& l : limbs )
+                l = ( std::uint64_t( std::rand() ) << 42 ) ^ ( std::uint64_t( std::rand() ) << 21 ) ^ std::rand();
+
+            IntList expected( 0 );
+            for ( auto l = limbs.rbegin(); l != limbs.rend(); ++l ) {
+                IntList next = karatsuba( expected, base ) + IntList( *l );
+                expected = std::move( next );
+            }
+            BOOST_CHECK( from_binary( limbs ) == expected );
+        }
+    }
+}
+
 #endif // BUILD_UNIT_TESTS
@@ -8,9 +8,93 @@
 #ifndef __karatsuba_h
 #define __karatsuba_h
 
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
 #include "IntList.h"
+#include "SparseIntList.h"
+#include "WorkStealingPool.h"
+
+class IntListAccumulator;
+
+IntList karatsuba(const IntList& x, const IntList& y);
+
+// parallel variants: fork the independent sub-products of the recursion as
+// tasks until the operands get down to 'cutoff_digits', then continue
+// sequentially. The first runs on at most 'threads' threads (the caller's and
+// up to threads-1 of the shared pool's workers) by only forking while it has
+// fewer than threads-1 forks in flight; the second forks all the way down to
+// the cutoff on the pool it is given.
+const unsigned long default_parallel_cutoff_digits = 2048;
+IntList karatsuba_parallel(const IntList& x, const IntList& y, unsigned int threads,
+                           unsigned long cutoff_digits = default_parallel_cutoff_digits);
+IntList karatsuba_parallel(const IntList& x, const IntList& y, WorkStealingPool& pool,
+                           unsigned long cutoff_digits = default_parallel_cutoff_digits);
+
+// batch variant: out[i] = *pairs[i].first * *pairs[i].second. Pairs of similar
+// size are run together, spread over the pool's workers, and share each
+// worker's scratch memory; out must be at least as long as pairs.
+void multiply_batch(std::span<const std::pair<const IntList*, const IntList*>> pairs, std::span<IntList> out,
+                    WorkStealingPool& pool = WorkStealingPool::shared());
+
+SparseIntList karatsuba(const SparseIntList& x, const SparseIntList& y);
+
+// whether karatsuba(x, y) multiplies them block by block, as above (at least
+// one is sparse, and the block products are estimated to cost less than the
+// dense recursion), rather than densely
+bool karatsuba_goes_sparse(const IntList& x, const IntList& y);
+
+// the decimal value of a binary number given as 64-bit limbs, least
+// significant first, converted by divide and conquer on top of karatsuba
+IntList from_binary(std::span<const std::uint64_t> limbs);
+
+// estimated relative cost of karatsuba(x, y) for operands of these lengths:
+// n^log2(3) for the longer one, n, since the shorter gets padded out to it
+double karatsuba_cost(unsigned long x_digits, unsigned long y_digits);
+
+// one level of the recursion, for code that drives it itself (scheduling the
+// sub-products as separate tasks, say): karatsuba_split cuts x and y (at
+// least one of them 2+ digits long) at m digits into the operands of the three
+// half-size sub-products, and karatsuba_join puts those products back together
+// into x*y.
+struct karatsuba_step
+{
+    unsigned long m;
+    std::pair<IntList, IntList> s1, s2, s1xs2;   // (a,c), (b,d) and (a+b,c+d)
+};
+karatsuba_step karatsuba_split(const IntList& x, const IntList& y);
+IntList karatsuba_join(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m);
+
+// (the same, adding it up in the caller's accumulator rather than this
+// thread's own)
+IntList karatsuba_join(const IntList& s1, const IntList& s2, const IntList& s1xs2, unsigned long m,
+                       IntListAccumulator& scratch);
+
+// il, zero-padded to total_digits, cut into its first spl_idx digits and the
+// rest (the split karatsuba makes at each level)
+std::pair<IntList, IntList> split_zero_padded_int_list(const IntList& il, unsigned int spl_idx, unsigned int total_digits);
+
+// for code that works at nominal lengths rather than the operands' own (so it
+// can make the same splits whatever the digits): where karatsuba splits
+// operands 'digits' long (the low half gets the ceil), and x zero-padded to
+// that length cut there into its halves and their sum, x's side of the three
+// sub-products
+unsigned long karatsuba_split_point(unsigned long digits);
+struct karatsuba_halves
+{
+    IntList hi, lo, sum;
+};
+karatsuba_halves split_into_halves(const IntList& x, unsigned long digits);
+
+// (the same, into halves the caller keeps between splits, in their storage)
+void split_into_halves(const IntList& x, unsigned long digits, karatsuba_halves& into);
 
-int_list_sp karatsuba(const IntList& x, const IntList& y);
+// x cut into piece_digits-digit pieces from the lsd end (the last one what's
+// left), each with its offset in digits, for multiplying an operand much
+// longer than the other a piece at a time
+std::vector<std::pair<IntList, unsigned long>> lsd_pieces(const IntList& x, unsigned long piece_digits);
 
 #endif // __karatsuba_h 
 
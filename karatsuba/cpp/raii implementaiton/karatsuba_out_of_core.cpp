@@ -0,0 +1,480 @@
+//
+// karatsuba_out_of_core.cpp
+//
+// created by PKXH on 18 Oct 2026
+//
+// Implementation of external-memory (out-of-core) Karatsuba multiplication
+//
+// NOTE: when updating code, compile with:
+// g++-11 -std=c++2a -pthread -DBUILD_KARATSUBA_OUT_OF_CORE_UNIT_TEST_RUNNER IntList.cpp SparseIntList.cpp IntListAccumulator.cpp WorkStealingPool.cpp IntListParallel.cpp IntListIO.cpp karatsuba.cpp karatsuba_out_of_core.cpp
+// and run a.out to test changes for breaks
+//
+
+// use this define to run unit tests without externally-defined test runner
+#if defined(BUILD_KARATSUBA_OUT_OF_CORE_UNIT_TEST_RUNNER)
+#define BOOST_TEST_MODULE Karatsuba Out Of Core Test
+#define BUILD_UNIT_TESTS
+#include <boost/test/included/unit_test.hpp>
+
+// use these defines ONLY when linking to an externally-defined test runner
+#elif defined(BUILD_KARATSUBA_OUT_OF_CORE_UNIT_TESTS) || defined(BUILD_ALL_UNIT_TESTS)
+#define BUILD_UNIT_TESTS
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "IntList.h"
+#include "IntListAccumulator.h"
+#include "IntListIO.h"
+#include "karatsuba.h"
+#include "karatsuba_out_of_core.h"
+#ifdef BUILD_UNIT_TESTS
+#include "IntListTestUtils.h"
+#endif
+
+// Rough resident bytes per digit of block size: the two operands of a
+// product small enough to do in memory (at most a block each), the Karatsuba
+// recursion's temporaries for it, and the column sums of a block's worth of a
+// combine, plus the mapped windows. Measured peaks come in a bit under this.
+static const std::size_t resident_bytes_per_block_digit = 160;
+static const std::size_t min_block_digits = 64;
+
+std::size_t out_of_core_block_digits( std::size_t rss_budget_bytes )
+{
+    return std::max( min_block_digits, rss_budget_bytes / resident_bytes_per_block_digit );
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+BOOST_AUTO_TEST_CASE( test_out_of_core_block_digits )
+{
+    BOOST_CHECK( out_of_core_block_digits( 1 ) == 64 );
+    BOOST_CHECK( out_of_core_block_digits( 64 * resident_bytes_per_block_digit ) == 64 );
+    BOOST_CHECK( out_of_core_block_digits( std::size_t(1) << 30 ) > 1000000 );
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
+
+
+
+// *******************************************************************************
+// disk_number
+// *******************************************************************************
+//
+// Digits [lo, lo+len) (counted from the lsd, so the value is the number in
+// the file divided by 10^lo, mod 10^len) of a decimal text file holding a
+// number 'digits' long. Digits are read and written a window at a time, so
+// none of it stays resident.
+//
+// *******************************************************************************
+//
+namespace {
+
+struct disk_number
+{
+    std::filesystem::path path;
+    std::size_t digits = 0;
+    std::size_t lo = 0, len = 0;
+
+    disk_number part( std::size_t from, std::size_t count ) const { return { path, digits, lo + from, count }; }
+
+    // the digits at 10^p .. 10^(p+w-1) (lsd first), 0 past the top
+    void read( std::size_t p, std::size_t w, std::vector<int>& out ) const
+    {
+        out.assign( w, 0 );
+        if ( p >= len )
+            return;
+
+        auto k = std::min( w, len - p );
+        MappedFile window( path, digits - (lo + p + k), k, MappedFile::access::read );
+        const char* text = window.data();
+        bool bad = false;
+        for ( std::size_t j = 0; j < k; ++j ) {
+            out[j] = text[k-1-j] - '0';
+            bad |= out[j] < 0 || out[j] > 9;
+        }
+        if ( bad )
+            throw std::invalid_argument( path.string() + " is not a decimal number" );
+    }
+
+    // (lo == 0 && len == digits) set the digits at 10^p .. 10^(p+w-1)
+    void write( std::size_t p, std::size_t w, const std::vector<int>& in ) const
+    {
+        MappedFile window( path, digits - (p + w), w, MappedFile::access::write );
+        char* text = window.data();
+        for ( std::size_t j = 0; j < w; ++j )
+            text[w-1-j] = char( '0' + in[j] );
+    }
+
+    IntList load() const
+    {
+        MappedFile window( path, digits - (lo + len), len, MappedFile::access::read );
+        return IntList( window.view() );
+    }
+};
+
+// an operand file; a trailing newline isn't part of the number (same as
+// IntList::load_mmap)
+disk_number operand( const std::filesystem::path& path )
+{
+    std::size_t digits = std::filesystem::file_size( path );
+    while ( digits > 0 ) {
+        MappedFile last( path, digits-1, 1, MappedFile::access::read );
+        if ( last.data()[0] != '\n' && last.data()[0] != '\r' )
+            break;
+        --digits;
+    }
+    if ( digits == 0 )
+        throw std::invalid_argument( "empty operand file " + path.string() );
+    return { path, digits, 0, digits };
+}
+
+// make an (unmapped) file of exactly 'size' bytes to map windows of
+void create_file( const std::filesystem::path& path, std::size_t size )
+{
+    { std::ofstream create( path, std::ios::binary | std::ios::trunc ); }
+    std::filesystem::resize_file( path, size );
+}
+
+// a file of 'digits' digits for an intermediate result, removed again when
+// it goes out of scope (however that happens)
+class scratch_file
+{
+    disk_number n;
+
+public:
+    scratch_file( const std::filesystem::path& path, std::size_t digits ) : n { path, digits, 0, digits }
+    {
+        create_file( path, digits );
+    }
+    ~scratch_file()
+    {
+        std::error_code ignored;
+        std::filesystem::remove( n.path, ignored );
+    }
+    scratch_file( const scratch_file& ) = delete;
+    scratch_file& operator=( const scratch_file& ) = delete;
+
+    const disk_number& number() const { return n; }
+};
+
+
+
+// *******************************************************************************
+// out_of_core_multiply
+// *******************************************************************************
+//
+// The recursion itself: products of operands up to a block long are done in
+// memory with karatsuba(); anything longer is split in two at m digits
+// (x = a*10^m + b, y = c*10^m + d) and put back together from the three
+// sub-products a*c, b*d and (a+b)*(c+d), each of which is another file. If y
+// is too short to split there, x is just cut in two and each half multiplied
+// by all of y instead (y*a*10^m + y*b).
+//
+// The sums and the final combine are one lsd-to-msd pass over their inputs a
+// block at a time, with a signed carry (so subtracting a*c and b*d from the
+// middle product needs no intermediate file of its own).
+//
+// *******************************************************************************
+//
+class out_of_core_multiply
+{
+    std::size_t B;
+    std::filesystem::path scratch_prefix;
+    unsigned long scratch_count = 0;
+
+    struct term { const disk_number& n; std::size_t shift; int sign; };
+
+    scratch_file scratch( std::size_t digits )
+    {
+        auto path = scratch_prefix;
+        path += "." + std::to_string( scratch_count++ );
+        return scratch_file( path, digits );
+    }
+
+    // out = the sum of every term (times its sign, shifted up by its shift)
+    void combine( std::initializer_list<term> terms, const disk_number& out ) const
+    {
+        std::size_t extent = out.len;
+        for ( auto& t : terms )
+            extent = std::max( extent, t.shift + t.n.len );
+
+        std::vector<int> in, digits;
+        std::vector<long long> column;
+        long long carry = 0;
+        bool overflow = false;
+
+        for ( std::size_t p = 0; p < extent; p += B ) {
+            const std::size_t w = std::min( B, extent - p );
+            column.assign( w, 0 );
+            for ( auto& t : terms ) {
+                if ( p + w <= t.shift )
+                    continue;
+                auto below = p < t.shift ? t.shift - p : 0;   // the block's positions under the term
+                t.n.read( p + below - t.shift, w - below, in );
+                for ( std::size_t j = 0; j < w - below; ++j )
+                    column[below + j] += t.sign * in[j];
+            }
+
+            digits.resize( w );
+            for ( std::size_t j = 0; j < w; ++j ) {
+                long long c = column[j] + carry;
+                long long d = c % 10;
+                carry = c / 10;
+                if ( d < 0 ) {
+                    d += 10;
+                    carry -= 1;
+                }
+                digits[j] = int( d );
+            }
+
+            // (past the end of out, the digits must all come out 0)
+            if ( p < out.len )
+                out.write( p, std::min( w, out.len - p ), digits );
+            for ( std::size_t j = ( p < out.len ? out.len - p : 0 ); j < w; ++j )
+                overflow |= digits[j] != 0;
+        }
+
+        if ( overflow || carry != 0 )
+            throw std::logic_error( "out-of-core product overflowed its " + std::to_string(out.len) + " digits" );
+    }
+
+public:
+    out_of_core_multiply( std::size_t block_digits, const std::filesystem::path& scratch_prefix )
+        : B( block_digits ), scratch_prefix( scratch_prefix ) {}
+
+    // out (a whole file, x.len + y.len digits long) = x*y
+    void multiply( const disk_number& x, const disk_number& y, const disk_number& out )
+    {
+        if ( x.len < y.len )
+            return multiply( y, x, out );
+
+        if ( x.len <= B ) {
+            auto product = karatsuba( x.load(), y.load() );
+            MappedFile window( out.path, 0, out.len, MappedFile::access::write );
+            std::fill_n( window.data(), out.len - product.size(), '0' );
+            product.write_chars( window.data() + out.len - product.size(), 0, product.size() );
+            return;
+        }
+
+        const std::size_t m = x.len - x.len/2;
+        auto a = x.part( m, x.len - m );
+        auto b = x.part( 0, m );
+
+        if ( y.len <= m ) {
+            auto hi = scratch( a.len + y.len );
+            auto lo = scratch( b.len + y.len );
+            multiply( a, y, hi.number() );
+            multiply( b, y, lo.number() );
+            combine( { { lo.number(), 0, 1 }, { hi.number(), m, 1 } }, out );
+            return;
+        }
+
+        auto c = y.part( m, y.len - m );
+        auto d = y.part( 0, m );
+
+        auto z1 = scratch( 2*m + 2 );
+        {
+            auto a_b = scratch( m + 1 );
+            auto c_d = scratch( m + 1 );
+            combine( { { a, 0, 1 }, { b, 0, 1 } }, a_b.number() );
+            combine( { { c, 0, 1 }, { d, 0, 1 } }, c_d.number() );
+            multiply( a_b.number(), c_d.number(), z1.number() );
+        }
+        auto z2 = scratch( a.len + c.len );
+        auto z0 = scratch( b.len + d.len );
+        multiply( a, c, z2.number() );
+        multiply( b, d, z0.number() );
+
+        combine( { { z0.number(), 0,   1 },
+                   { z1.number(), m,   1 }, { z2.number(), m, -1 }, { z0.number(), m, -1 },
+                   { z2.number(), 2*m, 1 } }, out );
+    }
+};
+
+}
+
+
+
+// *******************************************************************************
+// Calculate a product of two on-disk operands with Karatsuba's recursion run
+// over files rather than IntLists.
+//
+// Each level splits its operands in half and recurses on the three half-size
+// products, just as karatsuba() does, so the whole multiply takes the same
+// O(n^1.585) digit operations, plus O(n) block reads and writes per level of
+// the recursion above the block size. Only the bottom of the recursion (the
+// products of at most a block each) is ever in memory, and B is picked so
+// that fits the budget.
+//
+// What it costs instead is disk: each level keeps its three sub-products (and,
+// for a while, the two sums) in scratch files next to product_path, so at the
+// deepest point there's about three times the product's length in scratch
+// files on top of the product itself. They're removed as each level finishes.
+//
+// The product is written into a temp file of len(x)+len(y) digits, which is
+// one more than the product needs about half the time; if it came out with a
+// leading zero (or more, if the operands had some) the rest is copied over
+// into the real file, otherwise the temp file just gets renamed.
+// *******************************************************************************
+//
+// -------------------------------------------------------------------------------
+//                                IMPLEMENTATION
+// -------------------------------------------------------------------------------
+//
+void karatsuba_out_of_core(const std::filesystem::path& x_path, const std::filesystem::path& y_path,
+                           const std::filesystem::path& product_path, std::size_t rss_budget_bytes) {
+
+    const std::size_t B = out_of_core_block_digits( rss_budget_bytes );
+
+    auto x = operand( x_path );
+    auto y = operand( y_path );
+    const std::size_t L = x.len + y.len;
+
+    auto partial_path = product_path;
+    partial_path += ".partial";
+    {
+        scratch_file partial( partial_path, L );
+        out_of_core_multiply( B, partial_path ).multiply( x, y, partial.number() );
+
+        //
+        // trim the leading zeros (keeping at least one digit)
+        //
+        std::size_t zeros = 0;
+        for ( bool nonzero = false; !nonzero && zeros < L-1; ) {
+            auto width = std::min( B, L-1 - zeros );
+            MappedFile window( partial_path, zeros, width, MappedFile::access::read );
+            auto run = std::find_if( window.data(), window.data() + width, []( char d ) { return d != '0'; } );
+            zeros += run - window.data();
+            nonzero = run != window.data() + width;
+        }
+
+        if ( zeros == 0 ) {
+            std::filesystem::rename( partial_path, product_path );
+            return;
+        }
+
+        create_file( product_path, L - zeros );
+        for ( std::size_t pos = 0; pos < L - zeros; pos += B ) {
+            auto width = std::min( B, L - zeros - pos );
+            MappedFile from( partial_path, zeros + pos, width, MappedFile::access::read );
+            MappedFile to( product_path, pos, width, MappedFile::access::write );
+            std::memcpy( to.data(), from.data(), width );
+        }
+    }
+}
+//
+// -------------------------------------------------------------------------------
+//                             FUNCTIONALITY TESTS
+// -------------------------------------------------------------------------------
+//
+#ifdef BUILD_UNIT_TESTS
+// the operand and product files a test multiplies through (removed when it's done)
+struct test_files
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::filesystem::path paths[3] = { dir / ("ooc_x_" + std::to_string(::getpid())),
+                                       dir / ("ooc_y_" + std::to_string(::getpid())),
+                                       dir / ("ooc_p_" + std::to_string(::getpid())) };
+    ~test_files()
+    {
+        std::error_code ignored;
+        for ( auto& p : paths )
+            std::filesystem::remove( p, ignored );
+    }
+};
+
+// with a budget this small the blocks are the minimum 64 digits, so even
+// modest operands go several levels down the recursion
+static const std::size_t tiny_budget = 1;
+
+BOOST_AUTO_TEST_CASE( test_out_of_core_karatsuba_multiplication )
+{
+    std::srand(time(nullptr));
+
+    test_files files;
+    auto& [x_path, y_path, p_path] = files.paths;
+
+    {   //
+        // random operands, several levels down the recursion
+        //
+        for ( int i=0; i < 20; i++ ) {
+            auto x = random_int_list( 1 + std::rand() % 1500 );
+            auto y = random_int_list( 1 + std::rand() % 1500 );
+            x.save( x_path );
+            y.save( y_path );
+
+            karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget );
+            BOOST_CHECK( IntList::load_mmap( p_path ) == karatsuba( x, y ) );
+            BOOST_CHECK( !std::filesystem::exists( p_path.string() + ".partial" ) );
+        }
+    }
+
+    {   //
+        // lopsided operands (too short to split where the long one does), and
+        // no scratch files left behind
+        //
+        auto x = random_int_list( 3000 );
+        auto y = random_int_list( 100 );
+        x.save( x_path );
+        y.save( y_path );
+        karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget );
+        BOOST_CHECK( IntList::load_mmap( p_path ) == karatsuba( x, y ) );
+        karatsuba_out_of_core( y_path, x_path, p_path, tiny_budget );
+        BOOST_CHECK( IntList::load_mmap( p_path ) == karatsuba( x, y ) );
+
+        auto prefix = p_path.filename().string() + ".partial";
+        for ( auto& entry : std::filesystem::directory_iterator( files.dir ) )
+            BOOST_CHECK( entry.path().filename().string().rfind( prefix, 0 ) != 0 );
+    }
+
+    {   //
+        // all nines, so every sum and combine carries the whole way up
+        //
+        { std::ofstream( x_path ) << std::string( 777, '9' ); }
+        { std::ofstream( y_path ) << std::string( 1000, '9' ); }
+        karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget );
+        BOOST_CHECK( IntList::load_mmap( p_path ) == karatsuba( IntList( std::string( 777, '9' ) ),
+                                                                IntList( std::string( 1000, '9' ) ) ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_out_of_core_karatsuba_operands )
+{
+    test_files files;
+    auto& [x_path, y_path, p_path] = files.paths;
+
+    {   //
+        // operands with leading zeros and newlines, and zero itself
+        //
+        { std::ofstream( x_path ) << std::string( 200, '0' ) << "123456789\n"; }
+        { std::ofstream( y_path ) << "987654321\n"; }
+        karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget );
+        BOOST_CHECK( IntList::load_mmap( p_path ).to_str() == "121932631112635269" );
+
+        { std::ofstream( y_path ) << std::string( 300, '0' ); }
+        karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget );
+        BOOST_CHECK( IntList::load_mmap( p_path ) == IntList(0) );
+
+        { std::ofstream( y_path ) << "\n"; }
+        BOOST_CHECK_THROW( karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget ), std::invalid_argument );
+
+        { std::ofstream( y_path ) << std::string( 500, '1' ) << "x" << std::string( 500, '1' ); }
+        BOOST_CHECK_THROW( karatsuba_out_of_core( x_path, y_path, p_path, tiny_budget ), std::invalid_argument );
+        BOOST_CHECK( !std::filesystem::exists( p_path.string() + ".partial" ) );
+    }
+}
+#endif // BUILD_UNIT_TESTS
+// -------------------------------------------------------------------------------
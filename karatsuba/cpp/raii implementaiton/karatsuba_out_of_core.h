@@ -0,0 +1,30 @@
+//
+// karatsuba_out_of_core.h
+//
+// created by PKXH on 18 Oct 2026
+//
+// Declarations for external-memory (out-of-core) Karatsuba multiplication, for
+// operands too big to hold in memory as IntLists
+//
+#ifndef __karatsuba_out_of_core_h
+#define __karatsuba_out_of_core_h
+
+#include <cstddef>
+#include <filesystem>
+
+// Multiply the decimal text files at x_path and y_path (msd first, as written
+// by IntList::save) into a decimal text file at product_path, keeping the
+// resident memory of the multiply under about rss_budget_bytes. Operands and
+// product are only ever touched a block at a time through mapped windows; the
+// product (and the recursion's sub-products, a few times its size on disk at
+// most) are assembled in temp files next to product_path.
+const std::size_t default_out_of_core_rss_budget = std::size_t(1) << 30;
+
+void karatsuba_out_of_core(const std::filesystem::path& x_path, const std::filesystem::path& y_path,
+                           const std::filesystem::path& product_path,
+                           std::size_t rss_budget_bytes = default_out_of_core_rss_budget);
+
+// the block size (in digits) a given budget works out to
+std::size_t out_of_core_block_digits(std::size_t rss_budget_bytes);
+
+#endif // __karatsuba_out_of_core_h